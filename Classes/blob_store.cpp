@@ -0,0 +1,298 @@
+#include "blob_store.h"
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// ==================== BLOB ====================
+
+Blob::Blob(const char* bytes, size_t length, void* mapping)
+    : bytes(bytes), length(length), mapping(mapping) {
+}
+
+Blob::~Blob() {
+    if (mapping == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    delete[] static_cast<char*>(mapping);
+#else
+    munmap(mapping, length);
+#endif
+}
+
+// ==================== BLOB STORE ====================
+
+BlobStore::BlobStore(string root, size_t cacheLimit)
+    : root(root), cacheLimit(cacheLimit), cacheBytes(0) {
+    error_code ec;
+    fs::create_directories(this->root, ec);
+}
+
+// 64-bit FNV-1a; collisions are caught by comparing contents in put()
+string BlobStore::hashOf(const string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char ch : data) {
+        hash ^= static_cast<uint64_t>(static_cast<unsigned char>(ch));
+        hash *= 1099511628211ULL;
+    }
+    ostringstream oss;
+    oss << hex << setw(16) << setfill('0') << hash;
+    return oss.str();
+}
+
+string BlobStore::pathFor(const string& handle) const {
+    return root + "/" + handle + ".blob";
+}
+
+bool BlobStore::contains(const string& handle) const {
+    error_code ec;
+    return !handle.empty() && fs::exists(pathFor(handle), ec);
+}
+
+bool BlobStore::sameContent(const string& handle, const string& data) {
+    error_code ec;
+    if (fs::file_size(pathFor(handle), ec) != data.size() || ec) {
+        return false;
+    }
+    shared_ptr<const Blob> blob = get(handle);
+    return blob && memcmp(blob->data(), data.data(), data.size()) == 0;
+}
+
+string BlobStore::put(const string& data) {
+    string base = hashOf(data);
+    string handle = base;
+
+    // Identical content is stored only once
+    for (int n = 1; contains(handle); n++) {
+        if (sameContent(handle, data)) {
+            return handle;
+        }
+        handle = base + "-" + to_string(n);
+    }
+
+    // Write under a temporary name so readers never see a partial blob
+    string tmpPath = pathFor(handle) + ".tmp";
+    {
+        ofstream out(tmpPath, ios::binary);
+        if (!out || !out.write(data.data(), static_cast<streamsize>(data.size()))) {
+            return "";
+        }
+    }
+    error_code ec;
+    fs::rename(tmpPath, pathFor(handle), ec);
+    return ec ? "" : handle;
+}
+
+string BlobStore::putFile(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return "";
+    }
+    ostringstream contents;
+    contents << in.rdbuf();
+    return put(contents.str());
+}
+
+shared_ptr<const Blob> BlobStore::load(const string& handle) const {
+    string path = pathFor(handle);
+
+#ifdef _WIN32
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        return nullptr;
+    }
+    size_t length = static_cast<size_t>(in.tellg());
+    char* buffer = length > 0 ? new char[length] : nullptr;
+    in.seekg(0);
+    in.read(buffer, static_cast<streamsize>(length));
+    return make_shared<const Blob>(buffer, length, buffer);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        close(fd);
+        return make_shared<const Blob>("", 0, nullptr);
+    }
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file contents alive
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    return make_shared<const Blob>(static_cast<const char*>(mapping), length, mapping);
+#endif
+}
+
+shared_ptr<const Blob> BlobStore::get(const string& handle) {
+    lock_guard<mutex> guard(cacheLock);
+    auto hit = cache.find(handle);
+    if (hit != cache.end()) {
+        lru.splice(lru.begin(), lru, hit->second);
+        return hit->second->second;
+    }
+
+    if (handle.empty()) {
+        return nullptr;
+    }
+    shared_ptr<const Blob> blob = load(handle);
+    if (!blob) {
+        return nullptr;
+    }
+
+    // Blobs larger than the whole cache are handed out uncached
+    if (blob->size() <= cacheLimit) {
+        lru.emplace_front(handle, blob);
+        cache[handle] = lru.begin();
+        cacheBytes += blob->size();
+        evict();
+    }
+    return blob;
+}
+
+size_t BlobStore::cachedBytes() const {
+    lock_guard<mutex> guard(cacheLock);
+    return cacheBytes;
+}
+
+// Called with cacheLock held
+void BlobStore::evict() {
+    while (cacheBytes > cacheLimit && !lru.empty()) {
+        cacheBytes -= lru.back().second->size();
+        cache.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+bool BlobStore::writeTo(const string& handle, ostream& out) {
+    shared_ptr<const Blob> blob = get(handle);
+    if (!blob) {
+        return false;
+    }
+    return static_cast<bool>(out.write(blob->data(), static_cast<streamsize>(blob->size())));
+}
+
+// ==================== DATA URIS ====================
+
+static const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static string base64Encode(const char* data, size_t length) {
+    string encoded;
+    encoded.reserve((length + 2) / 3 * 4);
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t group = static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << 16;
+        if (i + 1 < length) {
+            group |= static_cast<uint32_t>(static_cast<unsigned char>(data[i + 1])) << 8;
+        }
+        if (i + 2 < length) {
+            group |= static_cast<uint32_t>(static_cast<unsigned char>(data[i + 2]));
+        }
+        encoded += BASE64_CHARS[group >> 18 & 0x3F];
+        encoded += BASE64_CHARS[group >> 12 & 0x3F];
+        encoded += i + 1 < length ? BASE64_CHARS[group >> 6 & 0x3F] : '=';
+        encoded += i + 2 < length ? BASE64_CHARS[group & 0x3F] : '=';
+    }
+    return encoded;
+}
+
+// Value of each base64 character, or -1; one lookup per input byte
+struct Base64Table {
+    signed char values[256];
+
+    Base64Table() {
+        memset(values, -1, sizeof(values));
+        for (int i = 0; i < 64; i++) {
+            values[static_cast<unsigned char>(BASE64_CHARS[i])] = static_cast<signed char>(i);
+        }
+    }
+};
+
+static bool base64Decode(const string& text, size_t begin, string& decoded) {
+    static const Base64Table table;
+    decoded.clear();
+    decoded.reserve((text.size() - begin) / 4 * 3);
+    uint32_t group = 0;
+    int bits = 0;
+    size_t i = begin;
+    for (; i < text.size() && text[i] != '='; i++) {
+        int value = table.values[static_cast<unsigned char>(text[i])];
+        if (value < 0) {
+            return false;
+        }
+        group = (group << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            decoded += static_cast<char>(group >> bits & 0xFF);
+        }
+    }
+    // Only padding may follow
+    for (; i < text.size(); i++) {
+        if (text[i] != '=') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The form accepts image/*, so recognise the common formats by signature
+static const char* sniffMimeType(const char* data, size_t length) {
+    string head(data, min<size_t>(length, 12));
+    if (head.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0) return "image/png";
+    if (head.compare(0, 3, "\xFF\xD8\xFF") == 0) return "image/jpeg";
+    if (head.compare(0, 4, "GIF8") == 0) return "image/gif";
+    if (head.size() == 12 && head.compare(0, 4, "RIFF") == 0 && head.compare(8, 4, "WEBP") == 0) {
+        return "image/webp";
+    }
+    if (head.compare(0, 2, "BM") == 0) return "image/bmp";
+    if (head.compare(0, 4, "<svg") == 0 || head.compare(0, 5, "<?xml") == 0) return "image/svg+xml";
+    return "application/octet-stream";
+}
+
+string BlobStore::putDataUri(const string& uri) {
+    const string marker = ";base64,";
+    size_t comma = uri.find(marker);
+    if (uri.compare(0, 5, "data:") != 0 || comma == string::npos) {
+        return "";
+    }
+    string bytes;
+    if (!base64Decode(uri, comma + marker.size(), bytes)) {
+        return "";
+    }
+    return put(bytes);
+}
+
+string BlobStore::dataUriFor(const string& handle) {
+    shared_ptr<const Blob> blob = get(handle);
+    if (!blob) {
+        return "";
+    }
+    return string("data:") + sniffMimeType(blob->data(), blob->size()) + ";base64," +
+           base64Encode(blob->data(), blob->size());
+}
@@ -0,0 +1,77 @@
+#ifndef BLOB_STORE_H
+#define BLOB_STORE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <iostream>
+#include <cstddef>
+
+// Read-only view of one stored blob. The bytes stay memory-mapped for as
+// long as someone holds the pointer, so readers never copy them.
+class Blob {
+private:
+    const char* bytes;
+    size_t length;
+    void* mapping;              // mmap region (or heap buffer on Windows)
+
+public:
+    Blob(const char* bytes, size_t length, void* mapping);
+    ~Blob();
+    Blob(const Blob&) = delete;
+    Blob& operator=(const Blob&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Content-addressed store for profile pictures. Each distinct image is
+// written once to <root>/<handle>.blob and employees only keep the short
+// handle, so rosters no longer drag image data around. Blobs are loaded
+// lazily on first use and recently used ones are kept in an LRU cache.
+// Lookups may come from several threads at once.
+class BlobStore {
+private:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const Blob>>> LruList;
+
+    std::string root;
+    size_t cacheLimit;          // bytes
+    size_t cacheBytes;
+    LruList lru;                // most recently used first
+    std::unordered_map<std::string, LruList::iterator> cache;
+    mutable std::mutex cacheLock;
+
+    std::string pathFor(const std::string& handle) const;
+    bool sameContent(const std::string& handle, const std::string& data);
+    std::shared_ptr<const Blob> load(const std::string& handle) const;
+    void evict();
+
+public:
+    explicit BlobStore(std::string root = "profile_pictures",
+                       size_t cacheLimit = 32 * 1024 * 1024);
+
+    // Store the bytes (if not already present) and return their handle
+    std::string put(const std::string& data);
+    std::string putFile(const std::string& path);
+
+    // Null when the handle is unknown
+    std::shared_ptr<const Blob> get(const std::string& handle);
+    bool contains(const std::string& handle) const;
+
+    // Stream a blob straight from its mapping
+    bool writeTo(const std::string& handle, std::ostream& out);
+
+    // Inline images as the web form stores them ("data:image/png;base64,...").
+    // putDataUri() returns "" when the value is not a base64 data URI;
+    // dataUriFor() returns "" when the handle is unknown.
+    std::string putDataUri(const std::string& uri);
+    std::string dataUriFor(const std::string& handle);
+
+    size_t cachedBytes() const;
+
+    static std::string hashOf(const std::string& data);
+};
+
+#endif // BLOB_STORE_H
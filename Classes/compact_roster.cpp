@@ -0,0 +1,437 @@
+#include "compact_roster.h"
+#include "thread_pool.h"
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+// ==================== VARINT HELPERS ====================
+
+static void writeVarint(vector<unsigned char>& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static size_t readVarint(const vector<unsigned char>& in, size_t& pos) {
+    size_t value = 0;
+    int shift = 0;
+    while (in[pos] & 0x80) {
+        value |= static_cast<size_t>(in[pos++] & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<size_t>(in[pos++]) << shift;
+    return value;
+}
+
+// Decode the next entry at pos on top of the previous string in cur
+static void readEntry(const vector<unsigned char>& data, size_t& pos, string& cur) {
+    size_t shared = readVarint(data, pos);
+    size_t length = readVarint(data, pos);
+    cur.resize(shared);
+    cur.append(reinterpret_cast<const char*>(&data[pos]), length);
+    pos += length;
+}
+
+// ==================== FRONT-CODED DICTIONARY ====================
+
+void FrontCodedDictionary::build(vector<string> words) {
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+
+    data.clear();
+    bucketOffsets.clear();
+    count = words.size();
+
+    for (size_t i = 0; i < words.size(); i++) {
+        size_t shared = 0;
+        if (i % BUCKET_SIZE == 0) {
+            bucketOffsets.push_back(static_cast<uint32_t>(data.size()));
+        } else {
+            const string& prev = words[i - 1];
+            while (shared < prev.size() && shared < words[i].size() &&
+                   prev[shared] == words[i][shared]) {
+                shared++;
+            }
+        }
+        writeVarint(data, shared);
+        writeVarint(data, words[i].size() - shared);
+        data.insert(data.end(), words[i].begin() + static_cast<ptrdiff_t>(shared), words[i].end());
+    }
+    data.shrink_to_fit();
+    bucketOffsets.shrink_to_fit();
+}
+
+string FrontCodedDictionary::bucketHead(size_t bucket) const {
+    size_t pos = bucketOffsets[bucket];
+    string head;
+    readEntry(data, pos, head);
+    return head;
+}
+
+uint32_t FrontCodedDictionary::find(const string& word) const {
+    if (count == 0) {
+        return NOT_FOUND;
+    }
+
+    // Last bucket whose head is <= word
+    size_t lo = 0, hi = bucketOffsets.size();
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (bucketHead(mid) <= word) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t pos = bucketOffsets[lo];
+    size_t first = lo * BUCKET_SIZE;
+    size_t last = min(count, first + BUCKET_SIZE);
+    string cur;
+    for (size_t id = first; id < last; id++) {
+        readEntry(data, pos, cur);
+        if (cur == word) {
+            return static_cast<uint32_t>(id);
+        }
+        if (cur > word) {
+            break;
+        }
+    }
+    return NOT_FOUND;
+}
+
+string FrontCodedDictionary::at(uint32_t id) const {
+    size_t pos = bucketOffsets[id / BUCKET_SIZE];
+    string cur;
+    for (size_t k = 0; k <= id % BUCKET_SIZE; k++) {
+        readEntry(data, pos, cur);
+    }
+    return cur;
+}
+
+size_t FrontCodedDictionary::bytesUsed() const {
+    return data.capacity() + bucketOffsets.capacity() * sizeof(uint32_t);
+}
+
+// ==================== INTERN TABLE ====================
+
+// Returns NOT_FOUND once the table holds 65535 distinct values
+uint16_t InternTable::intern(const string& value) {
+    auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    if (values.size() >= NOT_FOUND) {
+        return NOT_FOUND;
+    }
+    uint16_t id = static_cast<uint16_t>(values.size());
+    values.push_back(value);
+    ids[value] = id;
+    return id;
+}
+
+uint16_t InternTable::find(const string& value) const {
+    auto it = ids.find(value);
+    return it != ids.end() ? it->second : NOT_FOUND;
+}
+
+size_t InternTable::bytesUsed() const {
+    size_t bytes = values.capacity() * sizeof(string) +
+                   ids.bucket_count() * sizeof(void*) +
+                   ids.size() * (sizeof(string) + sizeof(uint16_t) + sizeof(void*));
+    for (const auto& value : values) {
+        bytes += value.capacity() > 15 ? value.capacity() + 1 : 0;
+    }
+    return bytes;
+}
+
+// ==================== PACKING HELPERS ====================
+
+// "(123) 456-7890" -> 1234567890
+static bool packPhone(const string& phone, uint64_t& packed) {
+    static const char SHAPE[] = "(ddd) ddd-dddd";
+    if (phone.size() != sizeof(SHAPE) - 1) {
+        return false;
+    }
+    packed = 0;
+    for (size_t i = 0; i < phone.size(); i++) {
+        if (SHAPE[i] == 'd') {
+            if (!isdigit(static_cast<unsigned char>(phone[i]))) {
+                return false;
+            }
+            packed = packed * 10 + static_cast<uint64_t>(phone[i] - '0');
+        } else if (phone[i] != SHAPE[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static string unpackPhone(uint64_t packed) {
+    ostringstream digits;
+    digits << setw(10) << setfill('0') << packed;
+    string d = digits.str();
+    return "(" + d.substr(0, 3) + ") " + d.substr(3, 3) + "-" + d.substr(6, 4);
+}
+
+// Same format as Employee::generateEmployeeId()
+static string formatEmployeeId(uint32_t number) {
+    ostringstream oss;
+    oss << "EMP" << setw(3) << setfill('0') << number;
+    return oss.str();
+}
+
+static bool packEmployeeId(const string& id, uint32_t& packed) {
+    if (id.size() < 6 || id.size() > 12 || id.compare(0, 3, "EMP") != 0) {
+        return false;
+    }
+    uint64_t number = 0;
+    for (size_t i = 3; i < id.size(); i++) {
+        if (!isdigit(static_cast<unsigned char>(id[i]))) {
+            return false;
+        }
+        number = number * 10 + static_cast<uint64_t>(id[i] - '0');
+    }
+    if (number >= (1u << 31)) {
+        return false;
+    }
+    packed = static_cast<uint32_t>(number);
+    // Reject IDs the formatter would not reproduce, e.g. "EMP0042"
+    return formatEmployeeId(packed) == id;
+}
+
+// ==================== COMPACT ROSTER ====================
+
+void CompactRoster::build(const vector<shared_ptr<Employee>>& employees) {
+    records.clear();
+    emailLocals.clear();
+    rawValues.clear();
+    rawFields.clear();
+    domains = InternTable();
+    departments = InternTable();
+    genders = InternTable();
+    employeeTypes = InternTable();
+
+    vector<string> first, last;
+    first.reserve(employees.size());
+    last.reserve(employees.size());
+    for (const auto& emp : employees) {
+        first.push_back(emp->getFirstName());
+        last.push_back(emp->getLastName());
+    }
+    firstNames.build(first);
+    lastNames.build(last);
+
+    // Domain 0 is "no domain": the whole address sits in the local part
+    domains.intern("");
+    records.reserve(employees.size());
+
+    for (const auto& emp : employees) {
+        Record rec;
+
+        string id = emp->getEmployeeId();
+        if (!packEmployeeId(id, rec.idNumber)) {
+            rec.idNumber = RAW_ID_FLAG | static_cast<uint32_t>(rawValues.size());
+            rawValues.push_back(id);
+        }
+
+        string phone = emp->getPhone();
+        if (!packPhone(phone, rec.phone)) {
+            rec.phone = RAW_PHONE_FLAG | rawValues.size();
+            rawValues.push_back(phone);
+        }
+
+        rec.firstName = firstNames.find(emp->getFirstName());
+        rec.lastName = lastNames.find(emp->getLastName());
+
+        string email = emp->getEmail();
+        size_t at = email.rfind('@');
+        rec.emailDomain = 0;
+        if (at != string::npos) {
+            uint16_t domain = domains.intern(email.substr(at));
+            if (domain != InternTable::NOT_FOUND) {
+                rec.emailDomain = domain;
+                email.resize(at);
+            }
+        }
+        rec.emailLocal = static_cast<uint32_t>(emailLocals.size());
+        emailLocals.insert(emailLocals.end(), email.begin(), email.end());
+
+        rec.department = internField(departments, emp->getDepartment(), RAW_DEPARTMENT);
+        rec.gender = internField(genders, emp->getGender(), RAW_GENDER);
+        rec.employeeType = internField(employeeTypes, emp->getEmployeeType(), RAW_EMPLOYEE_TYPE);
+
+        records.push_back(rec);
+    }
+
+    records.shrink_to_fit();
+    emailLocals.shrink_to_fit();
+}
+
+// Called while building, before the record is appended
+uint16_t CompactRoster::internField(InternTable& table, const string& value, RawSlot slot) {
+    uint16_t id = table.intern(value);
+    if (id == InternTable::NOT_FOUND) {
+        rawFields[rawKey(records.size(), slot)] = static_cast<uint32_t>(rawValues.size());
+        rawValues.push_back(value);
+        return RAW_FIELD;
+    }
+    return id;
+}
+
+const string& CompactRoster::fieldValue(const InternTable& table, uint16_t id,
+                                        size_t i, RawSlot slot) const {
+    if (id == RAW_FIELD) {
+        return rawValues[rawFields.at(rawKey(i, slot))];
+    }
+    return table.at(id);
+}
+
+string CompactRoster::getEmployeeId(size_t i) const {
+    uint32_t id = records[i].idNumber;
+    if (id & RAW_ID_FLAG) {
+        return rawValues[id & ~RAW_ID_FLAG];
+    }
+    return formatEmployeeId(id);
+}
+
+string CompactRoster::getFirstName(size_t i) const {
+    return firstNames.at(records[i].firstName);
+}
+
+string CompactRoster::getLastName(size_t i) const {
+    return lastNames.at(records[i].lastName);
+}
+
+string CompactRoster::getFullName(size_t i) const {
+    return getFirstName(i) + " " + getLastName(i);
+}
+
+string CompactRoster::getEmail(size_t i) const {
+    size_t begin = records[i].emailLocal;
+    size_t end = i + 1 < records.size() ? records[i + 1].emailLocal : emailLocals.size();
+    return string(emailLocals.begin() + static_cast<ptrdiff_t>(begin),
+                  emailLocals.begin() + static_cast<ptrdiff_t>(end)) +
+           domains.at(records[i].emailDomain);
+}
+
+string CompactRoster::getPhone(size_t i) const {
+    uint64_t phone = records[i].phone;
+    if (phone & RAW_PHONE_FLAG) {
+        return rawValues[phone & ~RAW_PHONE_FLAG];
+    }
+    return unpackPhone(phone);
+}
+
+string CompactRoster::getGender(size_t i) const {
+    return fieldValue(genders, records[i].gender, i, RAW_GENDER);
+}
+
+string CompactRoster::getDepartment(size_t i) const {
+    return fieldValue(departments, records[i].department, i, RAW_DEPARTMENT);
+}
+
+string CompactRoster::getEmployeeType(size_t i) const {
+    return fieldValue(employeeTypes, records[i].employeeType, i, RAW_EMPLOYEE_TYPE);
+}
+
+void CompactRoster::displayDetails(size_t i) const {
+    cout << "\n===== EMPLOYEE (COMPACT) =====\n";
+    cout << "Employee ID:    " << getEmployeeId(i) << endl;
+    cout << "Name:           " << getFullName(i) << endl;
+    cout << "Email:          " << getEmail(i) << endl;
+    cout << "Phone:          " << getPhone(i) << endl;
+    cout << "Gender:         " << getGender(i) << endl;
+    cout << "Department:     " << getDepartment(i) << endl;
+    cout << "Employee Type:  " << getEmployeeType(i) << endl;
+    cout << "==============================\n";
+}
+
+vector<size_t> CompactRoster::findByName(const string& fname, const string& lname) const {
+    vector<size_t> matches;
+    uint32_t first = firstNames.find(fname);
+    uint32_t last = lastNames.find(lname);
+    if (first == FrontCodedDictionary::NOT_FOUND || last == FrontCodedDictionary::NOT_FOUND) {
+        return matches;
+    }
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].firstName == first && records[i].lastName == last) {
+            matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+// An interned value matches by ID; only overflowed records compare strings
+vector<size_t> CompactRoster::filterByField(const InternTable& table, uint16_t Record::*member,
+                                            RawSlot slot, const string& value) const {
+    vector<size_t> matches;
+    uint16_t id = table.find(value);
+    if (id == InternTable::NOT_FOUND && rawFields.empty()) {
+        return matches;
+    }
+    for (size_t i = 0; i < records.size(); i++) {
+        uint16_t stored = records[i].*member;
+        if (stored == RAW_FIELD ? fieldValue(table, stored, i, slot) == value : stored == id) {
+            matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+vector<size_t> CompactRoster::filterByDepartment(const string& dept) const {
+    return filterByField(departments, &Record::department, RAW_DEPARTMENT, dept);
+}
+
+vector<size_t> CompactRoster::filterByType(const string& type) const {
+    return filterByField(employeeTypes, &Record::employeeType, RAW_EMPLOYEE_TYPE, type);
+}
+
+size_t CompactRoster::bytesUsed() const {
+    size_t bytes = sizeof(*this) +
+                   records.capacity() * sizeof(Record) +
+                   firstNames.bytesUsed() + lastNames.bytesUsed() +
+                   emailLocals.capacity() +
+                   domains.bytesUsed() + departments.bytesUsed() +
+                   genders.bytesUsed() + employeeTypes.bytesUsed() +
+                   rawValues.capacity() * sizeof(string) +
+                   rawFields.bucket_count() * sizeof(void*) +
+                   rawFields.size() * (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(void*));
+    for (const auto& raw : rawValues) {
+        bytes += raw.capacity() > 15 ? raw.capacity() + 1 : 0;
+    }
+    return bytes;
+}
+
+// Object + shared_ptr control block + pointer slot, plus every string that
+// outgrows the small-string buffer
+size_t CompactRoster::estimateRosterBytes(const vector<shared_ptr<Employee>>& employees) {
+    size_t slots = employees.capacity() * sizeof(shared_ptr<Employee>);
+    return ThreadPool::shared().parallelReduce(0, employees.size(), 4096, slots,
+        [&](size_t lo, size_t hi) {
+            size_t bytes = 0;
+            for (size_t i = lo; i < hi; i++) {
+                const auto& emp = employees[i];
+                bytes += sizeof(Employee) + 2 * sizeof(long);
+                const string fields[] = {
+                    emp->getEmployeeId(), emp->getFirstName(), emp->getLastName(),
+                    emp->getEmail(), emp->getPhone(), emp->getGender(),
+                    emp->getDepartment(), emp->getEmployeeType(), emp->getProfilePicture()
+                };
+                for (const auto& field : fields) {
+                    bytes += field.size() > 15 ? field.size() + 1 : 0;
+                }
+            }
+            return bytes;
+        },
+        [](size_t total, size_t chunk) {
+            return total + chunk;
+        });
+}
@@ -0,0 +1,134 @@
+#ifndef COMPACT_ROSTER_H
+#define COMPACT_ROSTER_H
+
+#include "employee.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Sorted string dictionary with front coding: strings are grouped in
+// buckets of 16 and every entry after the bucket head stores only the
+// length of the prefix it shares with its predecessor plus the rest.
+class FrontCodedDictionary {
+private:
+    static const size_t BUCKET_SIZE = 16;
+
+    std::vector<unsigned char> data;
+    std::vector<uint32_t> bucketOffsets;
+    size_t count;
+
+    std::string bucketHead(size_t bucket) const;
+
+public:
+    static const uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    FrontCodedDictionary() : count(0) {}
+
+    // Sorts and de-duplicates the words; IDs follow sorted order
+    void build(std::vector<std::string> words);
+
+    uint32_t find(const std::string& word) const;
+    std::string at(uint32_t id) const;
+
+    size_t size() const { return count; }
+    size_t bytesUsed() const;
+};
+
+// Small table of repeated values (departments, email domains, ...)
+class InternTable {
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, uint16_t> ids;
+
+public:
+    static const uint16_t NOT_FOUND = 0xFFFF;
+
+    uint16_t intern(const std::string& value);
+    uint16_t find(const std::string& value) const;
+    const std::string& at(uint16_t id) const { return values[id]; }
+    size_t bytesUsed() const;
+};
+
+// Read-only, compressed snapshot of the form fields of a large roster.
+// Phone numbers in the "(xxx) xxx-xxxx" form are packed into integers,
+// "EMPnnn" IDs into their number, emails are split into a local part and
+// an interned domain, and names go into front-coded dictionaries. Values
+// that do not fit a packed shape are kept verbatim, so nothing is lost.
+// Strings are only rebuilt when a field is read.
+class CompactRoster {
+private:
+    // 32 bytes per employee
+    struct Record {
+        uint64_t phone;         // digits, or RAW_PHONE_FLAG | index into rawValues
+        uint32_t idNumber;      // EMPnnn number, or RAW_ID_FLAG | index
+        uint32_t firstName;     // firstNames dictionary ID
+        uint32_t lastName;      // lastNames dictionary ID
+        uint32_t emailLocal;    // offset into emailLocals, ends at the next record's
+        uint16_t emailDomain;   // domains ID, including the '@'
+        uint16_t department;    // interned ID, or RAW_FIELD
+        uint16_t gender;
+        uint16_t employeeType;
+    };
+
+    // Interned fields that did not fit their table (more than 65535
+    // distinct values) are marked RAW_FIELD and kept in rawValues
+    enum RawSlot { RAW_DEPARTMENT, RAW_GENDER, RAW_EMPLOYEE_TYPE };
+
+    static const uint64_t RAW_PHONE_FLAG = 1ULL << 63;
+    static const uint32_t RAW_ID_FLAG = 1u << 31;
+    static const uint16_t RAW_FIELD = InternTable::NOT_FOUND;
+
+    std::vector<Record> records;
+    FrontCodedDictionary firstNames;
+    FrontCodedDictionary lastNames;
+    std::vector<char> emailLocals;
+    InternTable domains;
+    InternTable departments;
+    InternTable genders;
+    InternTable employeeTypes;
+    std::vector<std::string> rawValues; // IDs, phones and fields that could not be packed
+    std::unordered_map<uint64_t, uint32_t> rawFields; // (record << 2 | slot) -> rawValues index
+
+    static uint64_t rawKey(size_t i, RawSlot slot) {
+        return static_cast<uint64_t>(i) << 2 | static_cast<uint64_t>(slot);
+    }
+    uint16_t internField(InternTable& table, const std::string& value, RawSlot slot);
+    const std::string& fieldValue(const InternTable& table, uint16_t id,
+                                  size_t i, RawSlot slot) const;
+    std::vector<size_t> filterByField(const InternTable& table, uint16_t Record::*member,
+                                      RawSlot slot, const std::string& value) const;
+
+public:
+    // Replace the snapshot with the given employees
+    void build(const std::vector<std::shared_ptr<Employee>>& employees);
+
+    size_t size() const { return records.size(); }
+
+    // Field access, decompressed on demand
+    std::string getEmployeeId(size_t i) const;
+    std::string getFirstName(size_t i) const;
+    std::string getLastName(size_t i) const;
+    std::string getFullName(size_t i) const;
+    std::string getEmail(size_t i) const;
+    std::string getPhone(size_t i) const;
+    std::string getGender(size_t i) const;
+    std::string getDepartment(size_t i) const;
+    std::string getEmployeeType(size_t i) const;
+
+    void displayDetails(size_t i) const;
+
+    // Lookups compare packed values without decompressing records
+    std::vector<size_t> findByName(const std::string& fname, const std::string& lname) const;
+    std::vector<size_t> filterByDepartment(const std::string& dept) const;
+    std::vector<size_t> filterByType(const std::string& type) const;
+
+    size_t bytesUsed() const;
+
+    // Approximate heap footprint of the regular shared_ptr<Employee> roster
+    static size_t estimateRosterBytes(const std::vector<std::shared_ptr<Employee>>& employees);
+};
+
+#endif // COMPACT_ROSTER_H
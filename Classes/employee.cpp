@@ -3,6 +3,8 @@
 #include <string>
 #include <iomanip>
 #include <sstream>
+#include <ctime>
+#include <vector>
 
 using namespace std;
 
@@ -13,6 +15,10 @@ int Employee::employeeCounter = 0;
 
 Employee::Employee() {
     employeeId = generateEmployeeId();
+    createdAt = updatedAt = time(nullptr);
+    dirtyFields = FIELD_ALL;
+    revision = 0;
+    persisted = false;
     firstName = "John";
     lastName = "Doe";
     email = "john.doe@company.com";
@@ -20,12 +26,20 @@ Employee::Employee() {
     gender = "Male";
     department = "IT";
     employeeType = "full-time";
+    kind = KIND_FULL_TIME;
+    typeFixed = false;
 }
 
 Employee::Employee(string fname, string lname, 
                    string email, string phone, string gender,
                    string dept, string type) {
     employeeId = generateEmployeeId();
+    kind = KIND_OTHER;
+    typeFixed = false;
+    createdAt = updatedAt = time(nullptr);
+    dirtyFields = FIELD_ALL;
+    revision = 0;
+    persisted = false;
     setFirstName(fname);
     setLastName(lname);
     setEmail(email);
@@ -51,44 +65,72 @@ void Employee::setEmployeeId(string id) {
 }
 
 void Employee::setFirstName(string fname) {
-    if (!fname.empty()) {
+    if (!fname.empty() && fname != firstName) {
         firstName = fname;
+        touch(FIELD_FIRST_NAME);
     }
 }
 
 void Employee::setLastName(string lname) {
-    if (!lname.empty()) {
+    if (!lname.empty() && lname != lastName) {
         lastName = lname;
+        touch(FIELD_LAST_NAME);
     }
 }
 
 void Employee::setEmail(string email) {
-    if (!email.empty()) {
+    if (!email.empty() && email != this->email) {
         this->email = email;
+        touch(FIELD_EMAIL);
     }
 }
 
 void Employee::setPhone(string phone) {
-    if (!phone.empty()) {
+    if (!phone.empty() && phone != this->phone) {
         this->phone = phone;
+        touch(FIELD_PHONE);
     }
 }
 
 void Employee::setGender(string gender) {
-    if (!gender.empty()) {
+    if (!gender.empty() && gender != this->gender) {
         this->gender = gender;
+        touch(FIELD_GENDER);
     }
 }
 
 void Employee::setDepartment(string dept) {
-    if (!dept.empty()) {
+    if (!dept.empty() && dept != department) {
         department = dept;
+        touch(FIELD_DEPARTMENT);
     }
 }
 
-void Employee::setEmployeeType(string type) {
-    if (!type.empty()) {
+bool Employee::setEmployeeType(string type) {
+    if (!type.empty() && type != employeeType) {
+        if (typeFixed) {
+            return false;
+        }
         employeeType = type;
+        if (type == FullTimeTraits::type) {
+            kind = KIND_FULL_TIME;
+        } else if (type == PartTimeTraits::type) {
+            kind = KIND_PART_TIME;
+        } else if (type == InternTraits::type) {
+            kind = KIND_INTERN;
+        } else {
+            kind = KIND_OTHER;
+        }
+        touch(FIELD_EMPLOYEE_TYPE);
+    }
+    return true;
+}
+
+// Only the handle is kept here; the image itself lives in the BlobStore
+void Employee::setProfilePicture(string handle) {
+    if (!handle.empty() && handle != profilePicture) {
+        profilePicture = handle;
+        touch(FIELD_PROFILE_PICTURE);
     }
 }
 
@@ -125,89 +167,86 @@ string Employee::getEmployeeType() const {
     return employeeType;
 }
 
-// Get full name
-string Employee::getFullName() const {
-    return firstName + " " + lastName;
+EmployeeKind Employee::getKind() const {
+    return kind;
 }
 
-// For sorting
-string Employee::getSortingKey() const {
-    return employeeId;
+string Employee::getProfilePicture() const {
+    return profilePicture;
 }
 
-// ==================== FULL-TIME EMPLOYEE ====================
+// Change tracking
+time_t Employee::getCreatedAt() const {
+    return createdAt;
+}
 
-FullTimeEmployee::FullTimeEmployee() 
-    : Employee("John", "Doe", "john@company.com", 
-               "(123) 456-7890", "Male", "IT", "full-time") {
+time_t Employee::getUpdatedAt() const {
+    return updatedAt;
 }
 
-FullTimeEmployee::FullTimeEmployee(string fname, string lname,
-                                   string email, string phone, string gender,
-                                   string dept) 
-    : Employee(fname, lname, email, phone, gender, dept, "full-time") {
+unsigned Employee::getDirtyFields() const {
+    return dirtyFields;
 }
 
-void FullTimeEmployee::displayDetails() const {
-    cout << "\n===== FULL-TIME EMPLOYEE =====\n";
-    cout << "Employee ID:    " << getEmployeeId() << endl;
-    cout << "Name:           " << getFullName() << endl;
-    cout << "Email:          " << getEmail() << endl;
-    cout << "Phone:          " << getPhone() << endl;
-    cout << "Gender:         " << getGender() << endl;
-    cout << "Department:     " << getDepartment() << endl;
-    cout << "Employee Type:  " << getEmployeeType() << endl;
-    cout << "===============================\n";
+bool Employee::isDirty() const {
+    return !persisted || dirtyFields != 0;
 }
 
-string FullTimeEmployee::getSortingKey() const {
-    return "FT_" + getEmployeeId();
+bool Employee::isPersisted() const {
+    return persisted;
 }
 
-// ==================== PART-TIME EMPLOYEE ====================
+// Used when loading rows that already exist in the database
+void Employee::setTimestamps(time_t created, time_t updated) {
+    createdAt = created;
+    updatedAt = updated;
+}
 
-PartTimeEmployee::PartTimeEmployee() 
-    : Employee("Jane", "Smith", "jane@company.com", 
-               "(234) 567-8901", "Female", "HR", "part-time") {
+unsigned long Employee::getRevision() const {
+    return revision;
 }
 
-PartTimeEmployee::PartTimeEmployee(string fname, string lname,
-                                   string email, string phone, string gender,
-                                   string dept) 
-    : Employee(fname, lname, email, phone, gender, dept, "part-time") {
+void Employee::markClean(unsigned fields) {
+    dirtyFields &= ~fields;
+    persisted = true;
 }
 
-void PartTimeEmployee::displayDetails() const {
-    cout << "\n===== PART-TIME EMPLOYEE =====\n";
-    cout << "Employee ID:    " << getEmployeeId() << endl;
-    cout << "Name:           " << getFullName() << endl;
-    cout << "Email:          " << getEmail() << endl;
-    cout << "Phone:          " << getPhone() << endl;
-    cout << "Gender:         " << getGender() << endl;
-    cout << "Department:     " << getDepartment() << endl;
-    cout << "Employee Type:  " << getEmployeeType() << endl;
-    cout << "===============================\n";
+void Employee::touch(unsigned field) {
+    dirtyFields |= field;
+    revision++;
+    updatedAt = time(nullptr);
 }
 
-string PartTimeEmployee::getSortingKey() const {
-    return "PT_" + getEmployeeId();
+// Get full name
+string Employee::getFullName() const {
+    return firstName + " " + lastName;
 }
 
-// ==================== INTERN EMPLOYEE ====================
+// ==================== TYPE-SPECIFIC OPERATIONS ====================
 
-InternEmployee::InternEmployee() 
-    : Employee("Bob", "Johnson", "bob@company.com", 
-               "(345) 678-9012", "Male", "IT", "intern") {
+void Employee::displayDetails() const {
+    switch(kind) {
+        case KIND_FULL_TIME: printDetails(FullTimeTraits::label); break;
+        case KIND_PART_TIME: printDetails(PartTimeTraits::label); break;
+        case KIND_INTERN:    printDetails(InternTraits::label); break;
+        default:             printDetails("EMPLOYEE"); break;
+    }
 }
 
-InternEmployee::InternEmployee(string fname, string lname,
-                               string email, string phone, string gender,
-                               string dept) 
-    : Employee(fname, lname, email, phone, gender, dept, "intern") {
+// For sorting
+string Employee::getSortingKey() const {
+    switch(kind) {
+        case KIND_FULL_TIME: return sortingKey(FullTimeTraits::prefix);
+        case KIND_PART_TIME: return sortingKey(PartTimeTraits::prefix);
+        case KIND_INTERN:    return sortingKey(InternTraits::prefix);
+        default:             return employeeId;
+    }
 }
 
-void InternEmployee::displayDetails() const {
-    cout << "\n===== INTERN EMPLOYEE =====\n";
+// Common body of displayDetails(), with the banner for the given type
+void Employee::printDetails(const char* label) const {
+    string title = label;
+    cout << "\n===== " << title << " =====\n";
     cout << "Employee ID:    " << getEmployeeId() << endl;
     cout << "Name:           " << getFullName() << endl;
     cout << "Email:          " << getEmail() << endl;
@@ -215,9 +254,35 @@ void InternEmployee::displayDetails() const {
     cout << "Gender:         " << getGender() << endl;
     cout << "Department:     " << getDepartment() << endl;
     cout << "Employee Type:  " << getEmployeeType() << endl;
-    cout << "============================\n";
+    if (!getProfilePicture().empty()) {
+        cout << "Profile Pic:    " << getProfilePicture() << endl;
+    }
+    cout << string(title.size() + 13, '=') << "\n";
 }
 
-string InternEmployee::getSortingKey() const {
-    return "IN_" + getEmployeeId();
-}
\ No newline at end of file
+string Employee::sortingKey(const char* prefix) const {
+    return prefix + employeeId;
+}
+
+// ==================== TYPED RECORDS ====================
+
+bool appendTyped(const Employee& emp, vector<TypedEmployee>& out) {
+    switch(emp.getKind()) {
+        case KIND_FULL_TIME: out.emplace_back(FullTimeEmployee(emp)); return true;
+        case KIND_PART_TIME: out.emplace_back(PartTimeEmployee(emp)); return true;
+        case KIND_INTERN:    out.emplace_back(InternEmployee(emp)); return true;
+        default:             return false;
+    }
+}
+
+const Employee& asEmployee(const TypedEmployee& emp) {
+    return std::visit([](const auto& e) -> const Employee& { return e; }, emp);
+}
+
+void displayDetails(const TypedEmployee& emp) {
+    std::visit([](const auto& e) { e.displayDetails(); }, emp);
+}
+
+string getSortingKey(const TypedEmployee& emp) {
+    return std::visit([](const auto& e) { return e.getSortingKey(); }, emp);
+}
@@ -3,8 +3,57 @@
 
 #include <string>
 #include <iostream>
+#include <ctime>
+#include <variant>
+#include <vector>
 
-// Base Employee class with only fields from your forms
+// Dirty bits, one per synced column (see SyncEngine)
+enum EmployeeField {
+    FIELD_FIRST_NAME      = 1 << 0,
+    FIELD_LAST_NAME       = 1 << 1,
+    FIELD_EMAIL           = 1 << 2,
+    FIELD_PHONE           = 1 << 3,
+    FIELD_GENDER          = 1 << 4,
+    FIELD_DEPARTMENT      = 1 << 5,
+    FIELD_EMPLOYEE_TYPE   = 1 << 6,
+    FIELD_PROFILE_PICTURE = 1 << 7,
+    FIELD_ALL             = (1 << 8) - 1
+};
+
+// Employee types from your form
+enum EmployeeKind {
+    KIND_FULL_TIME,
+    KIND_PART_TIME,
+    KIND_INTERN,
+    KIND_OTHER
+};
+
+// Compile-time description of each employee type
+struct FullTimeTraits {
+    static constexpr EmployeeKind kind = KIND_FULL_TIME;
+    static constexpr const char* type = "full-time";
+    static constexpr const char* label = "FULL-TIME EMPLOYEE";
+    static constexpr const char* prefix = "FT_";
+};
+
+struct PartTimeTraits {
+    static constexpr EmployeeKind kind = KIND_PART_TIME;
+    static constexpr const char* type = "part-time";
+    static constexpr const char* label = "PART-TIME EMPLOYEE";
+    static constexpr const char* prefix = "PT_";
+};
+
+struct InternTraits {
+    static constexpr EmployeeKind kind = KIND_INTERN;
+    static constexpr const char* type = "intern";
+    static constexpr const char* label = "INTERN EMPLOYEE";
+    static constexpr const char* prefix = "IN_";
+};
+
+// Employee record with only fields from your forms. Type-specific
+// behaviour is looked up from the type tag instead of virtual functions,
+// so records can be stored by value in contiguous containers. Records of
+// a fixed type (EmployeeOf) resolve it at compile time instead.
 class Employee {
 protected:
     std::string employeeId;
@@ -15,6 +64,16 @@ protected:
     std::string gender;
     std::string department;
     std::string employeeType; // "full-time", "part-time", "intern"
+    EmployeeKind kind;        // employeeType as an enum, for cheap dispatch
+    bool typeFixed;           // set by EmployeeOf; the type never changes
+    std::string profilePicture; // BlobStore handle, empty when not set
+    
+    // Change tracking (mirrors created_at/updated_at in the database)
+    std::time_t createdAt;
+    std::time_t updatedAt;
+    unsigned dirtyFields;
+    unsigned long revision;   // bumped on every change
+    bool persisted;
     
     // Static counter for auto-generating IDs
     static int employeeCounter;
@@ -26,11 +85,8 @@ public:
              std::string email, std::string phone, std::string gender,
              std::string dept, std::string type);
     
-    // Virtual destructor
-    virtual ~Employee() {}
-    
-    // Pure virtual function
-    virtual void displayDetails() const = 0;
+    // Dispatches on the type tag, so a later setEmployeeType() is honoured
+    void displayDetails() const;
     
     // Setter functions (exactly matching form fields)
     void setEmployeeId(std::string id);
@@ -40,7 +96,9 @@ public:
     void setPhone(std::string phone);
     void setGender(std::string gender);
     void setDepartment(std::string dept);
-    void setEmployeeType(std::string type);
+    // Returns false if the record's type is fixed and would change
+    bool setEmployeeType(std::string type);
+    void setProfilePicture(std::string handle);
     
     // Getter functions
     std::string getEmployeeId() const;
@@ -51,6 +109,20 @@ public:
     std::string getGender() const;
     std::string getDepartment() const;
     std::string getEmployeeType() const;
+    EmployeeKind getKind() const;
+    std::string getProfilePicture() const;
+    
+    // Change tracking
+    std::time_t getCreatedAt() const;
+    std::time_t getUpdatedAt() const;
+    unsigned getDirtyFields() const;
+    bool isDirty() const;
+    bool isPersisted() const;
+    unsigned long getRevision() const;
+    void setTimestamps(std::time_t created, std::time_t updated);
+    // Called once the row is confirmed in the database; only the given
+    // dirty bits are cleared
+    void markClean(unsigned fields = FIELD_ALL);
     
     // Static method to get next ID
     static std::string generateEmployeeId();
@@ -58,45 +130,69 @@ public:
     // Static method to reset counter (for testing)
     static void resetCounter() { employeeCounter = 0; }
     
+    // Continue numbering after IDs loaded from the database
+    static void setCounter(int value) { employeeCounter = value; }
+    
     // Utility functions
     std::string getFullName() const;
     
     // For sorting purposes
-    virtual std::string getSortingKey() const;
-};
-
-// Derived classes based on employee type from your form
-class FullTimeEmployee : public Employee {
-public:
-    FullTimeEmployee();
-    FullTimeEmployee(std::string fname, std::string lname,
-                     std::string email, std::string phone, std::string gender,
-                     std::string dept);
+    std::string getSortingKey() const;
     
-    void displayDetails() const override;
-    std::string getSortingKey() const override;
-};
-
-class PartTimeEmployee : public Employee {
-public:
-    PartTimeEmployee();
-    PartTimeEmployee(std::string fname, std::string lname,
-                     std::string email, std::string phone, std::string gender,
-                     std::string dept);
+protected:
+    // Shared bodies for the type-specific operations
+    void printDetails(const char* label) const;
+    std::string sortingKey(const char* prefix) const;
     
-    void displayDetails() const override;
-    std::string getSortingKey() const override;
+private:
+    void touch(unsigned field);
 };
 
-class InternEmployee : public Employee {
+// Employee whose type is part of its C++ type. setEmployeeType() refuses
+// to change it, so displayDetails() and getSortingKey() use the traits
+// directly and agree with Employee's tag-based versions. Adds no data
+// members, so it can be copied into an Employee without losing anything.
+template<typename Traits>
+class EmployeeOf : public Employee {
 public:
-    InternEmployee();
-    InternEmployee(std::string fname, std::string lname,
-                   std::string email, std::string phone, std::string gender,
-                   std::string dept);
+    static constexpr EmployeeKind staticKind = Traits::kind;
     
-    void displayDetails() const override;
-    std::string getSortingKey() const override;
+    EmployeeOf(std::string fname, std::string lname,
+               std::string email, std::string phone, std::string gender,
+               std::string dept)
+        : Employee(fname, lname, email, phone, gender, dept, Traits::type) {
+        typeFixed = true;
+    }
+    
+    // Copy of a record that already has this type (see appendTyped)
+    explicit EmployeeOf(const Employee& other) : Employee(other) {
+        typeFixed = true;
+    }
+    
+    void displayDetails() const { printDetails(Traits::label); }
+    std::string getSortingKey() const { return sortingKey(Traits::prefix); }
 };
 
+// Types used by the menus and sample data
+typedef EmployeeOf<FullTimeTraits> FullTimeEmployee;
+typedef EmployeeOf<PartTimeTraits> PartTimeEmployee;
+typedef EmployeeOf<InternTraits> InternEmployee;
+
+static_assert(sizeof(FullTimeEmployee) == sizeof(Employee) &&
+              sizeof(PartTimeEmployee) == sizeof(Employee) &&
+              sizeof(InternEmployee) == sizeof(Employee),
+              "EmployeeOf must not add data members");
+
+// A record held by value with its type known at compile time. Operations
+// on it go through std::visit, which calls the EmployeeOf version for the
+// held type; no tag is checked per call.
+typedef std::variant<FullTimeEmployee, PartTimeEmployee, InternEmployee> TypedEmployee;
+
+// Appends a typed copy of the record. Returns false for types without
+// traits ("other"), which only the tag-based Employee can hold.
+bool appendTyped(const Employee& emp, std::vector<TypedEmployee>& out);
+const Employee& asEmployee(const TypedEmployee& emp);
+void displayDetails(const TypedEmployee& emp);
+std::string getSortingKey(const TypedEmployee& emp);
+
 #endif // EMPLOYEE_H
\ No newline at end of file
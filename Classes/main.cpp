@@ -1,31 +1,51 @@
 #include "employee.h"
+#include "sync.h"
+#include "blob_store.h"
+#include "compact_roster.h"
+#include "thread_pool.h"
+#include "query_cache.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
 
 using namespace std;
 
 // Function prototypes
 void displayMenu();
-void addEmployee(vector<shared_ptr<Employee>>& employees);
+void addEmployee(vector<shared_ptr<Employee>>& employees, EmployeeIndex& index, QueryCache& cache);
 void displayAllEmployees(const vector<shared_ptr<Employee>>& employees);
-void searchEmployee(const vector<shared_ptr<Employee>>& employees);
-void updateEmployee(vector<shared_ptr<Employee>>& employees);
-void deleteEmployee(vector<shared_ptr<Employee>>& employees);
-void sortEmployees(vector<shared_ptr<Employee>>& employees);
-void filterEmployees(const vector<shared_ptr<Employee>>& employees);
+void searchEmployee(const vector<shared_ptr<Employee>>& employees, const EmployeeIndex& index,
+                    QueryCache& cache);
+void updateEmployee(vector<shared_ptr<Employee>>& employees, BlobStore& blobStore, QueryCache& cache);
+void deleteEmployee(vector<shared_ptr<Employee>>& employees, SyncEngine& syncEngine,
+                    EmployeeIndex& index, QueryCache& cache);
+void sortEmployees(vector<shared_ptr<Employee>>& employees, QueryCache& cache);
+void filterEmployees(const vector<shared_ptr<Employee>>& employees, const EmployeeIndex& index,
+                     QueryCache& cache);
+void syncChanges(vector<shared_ptr<Employee>>& employees, SyncEngine& syncEngine,
+                 EmployeeIndex& index, QueryCache& cache);
+void storageReport(const vector<shared_ptr<Employee>>& employees);
+void cacheReport(const QueryCache& cache);
+void exportProfilePicture(const vector<shared_ptr<Employee>>& employees, BlobStore& blobStore);
 
-// Helper functions for sorting
-bool compareById(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b);
-bool compareByName(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b);
-bool compareByDepartment(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b);
-bool compareByType(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b);
+// Helper functions for bulk operations (run on the shared thread pool)
+string renderEmployeeRows(const vector<shared_ptr<Employee>>& employees);
+template<typename Fn>
+double timeMicros(Fn fn);
 
 int main() {
     vector<shared_ptr<Employee>> employees;
+    BlobStore blobStore;
+    SyncEngine syncEngine(blobStore);
+    EmployeeIndex index;
+    QueryCache cache;
     int choice;
     
     // Reset counter at start
@@ -49,38 +69,55 @@ int main() {
                                                     "bob@employee.com", "(345) 678-9012", 
                                                     "Male", "IT"));
     
+    for (const auto& emp : employees) {
+        index[emp->getEmployeeId()] = emp;
+    }
+    
     cout << "Sample employees added to system.\n";
     cout << "Auto-generated IDs: EMP001, EMP002, EMP003\n";
+    cout << "(Load the roster from the sync menu before syncing to an existing database.)\n";
     
     do {
         displayMenu();
-        cout << "Enter your choice (1-8): ";
+        cout << "Enter your choice (1-12): ";
         cin >> choice;
         cin.ignore();
         
         switch(choice) {
             case 1:
-                addEmployee(employees);
+                addEmployee(employees, index, cache);
                 break;
             case 2:
                 displayAllEmployees(employees);
                 break;
             case 3:
-                searchEmployee(employees);
+                searchEmployee(employees, index, cache);
                 break;
             case 4:
-                updateEmployee(employees);
+                updateEmployee(employees, blobStore, cache);
                 break;
             case 5:
-                deleteEmployee(employees);
+                deleteEmployee(employees, syncEngine, index, cache);
                 break;
             case 6:
-                sortEmployees(employees);
+                sortEmployees(employees, cache);
                 break;
             case 7:
-                filterEmployees(employees);
+                filterEmployees(employees, index, cache);
                 break;
             case 8:
+                syncChanges(employees, syncEngine, index, cache);
+                break;
+            case 9:
+                storageReport(employees);
+                break;
+            case 10:
+                cacheReport(cache);
+                break;
+            case 11:
+                exportProfilePicture(employees, blobStore);
+                break;
+            case 12:
                 cout << "\nThank you for using the Employee Management System!\n";
                 break;
             default:
@@ -90,7 +127,7 @@ int main() {
         cout << "\nPress Enter to continue...";
         cin.get();
         
-    } while (choice != 8);
+    } while (choice != 12);
     
     return 0;
 }
@@ -104,11 +141,15 @@ void displayMenu() {
     cout << "5. Delete Employee\n";
     cout << "6. Sort Employees\n";
     cout << "7. Filter Employees\n";
-    cout << "8. Exit\n";
+    cout << "8. Sync Changes to Database\n";
+    cout << "9. Storage Report\n";
+    cout << "10. Query Cache Statistics\n";
+    cout << "11. Export Profile Picture\n";
+    cout << "12. Exit\n";
     cout << "=======================================\n";
 }
 
-void addEmployee(vector<shared_ptr<Employee>>& employees) {
+void addEmployee(vector<shared_ptr<Employee>>& employees, EmployeeIndex& index, QueryCache& cache) {
     int empType;
     string fname, lname, email, phone, gender, dept;
     
@@ -186,6 +227,8 @@ void addEmployee(vector<shared_ptr<Employee>>& employees) {
     }
     
     employees.push_back(newEmp);
+    index[newEmp->getEmployeeId()] = newEmp;
+    cache.onAdd(*newEmp);
     cout << "\nEmployee added successfully!\n";
     cout << "Auto-generated ID: " << newEmp->getEmployeeId() << endl;
     cout << "Total employees: " << employees.size() << endl;
@@ -208,17 +251,12 @@ void displayAllEmployees(const vector<shared_ptr<Employee>>& employees) {
          << setw(20) << "Email" << endl;
     cout << string(80, '-') << endl;
     
-    for (const auto& emp : employees) {
-        cout << left << setw(10) << emp->getEmployeeId()
-             << setw(20) << emp->getFullName()
-             << setw(15) << emp->getEmployeeType()
-             << setw(15) << emp->getDepartment()
-             << setw(20) << emp->getEmail() << endl;
-    }
+    cout << renderEmployeeRows(employees);
     cout << string(80, '-') << endl;
 }
 
-void searchEmployee(const vector<shared_ptr<Employee>>& employees) {
+void searchEmployee(const vector<shared_ptr<Employee>>& employees, const EmployeeIndex& index,
+                    QueryCache& cache) {
     int searchOption;
     string searchTerm;
     
@@ -235,38 +273,38 @@ void searchEmployee(const vector<shared_ptr<Employee>>& employees) {
     cout << "Enter search term: ";
     getline(cin, searchTerm);
     
-    bool found = false;
+    vector<shared_ptr<Employee>> matches;
     
-    for (const auto& emp : employees) {
-        bool match = false;
-        
-        switch(searchOption) {
-            case 1:
-                match = (emp->getEmployeeId() == searchTerm);
-                break;
-            case 2:
-                match = (emp->getFullName().find(searchTerm) != string::npos);
-                break;
-            case 3:
-                match = (emp->getDepartment().find(searchTerm) != string::npos);
-                break;
-            case 4:
-                match = (emp->getEmployeeType().find(searchTerm) != string::npos);
-                break;
-        }
-        
-        if (match) {
-            emp->displayDetails();
-            found = true;
+    switch(searchOption) {
+        case 1: {
+            // IDs are unique, so the index answers directly
+            auto it = index.find(searchTerm);
+            if (it != index.end()) {
+                matches.push_back(it->second);
+            }
+            break;
         }
+        case 2:
+            matches = runQuery(Query(QUERY_NAME, MATCH_CONTAINS, searchTerm), employees, index, cache);
+            break;
+        case 3:
+            matches = runQuery(Query(QUERY_DEPARTMENT, MATCH_CONTAINS, searchTerm), employees, index, cache);
+            break;
+        case 4:
+            matches = runQuery(Query(QUERY_TYPE, MATCH_CONTAINS, searchTerm), employees, index, cache);
+            break;
     }
     
-    if (!found) {
+    for (const auto& emp : matches) {
+        emp->displayDetails();
+    }
+    
+    if (matches.empty()) {
         cout << "No employees found matching your search!\n";
     }
 }
 
-void updateEmployee(vector<shared_ptr<Employee>>& employees) {
+void updateEmployee(vector<shared_ptr<Employee>>& employees, BlobStore& blobStore, QueryCache& cache) {
     string id;
     bool found = false;
     
@@ -284,7 +322,8 @@ void updateEmployee(vector<shared_ptr<Employee>>& employees) {
             cout << "1. Email\n";
             cout << "2. Phone\n";
             cout << "3. Department\n";
-            cout << "Enter choice (1-3): ";
+            cout << "4. Profile Picture\n";
+            cout << "Enter choice (1-4): ";
             cin >> updateChoice;
             cin.ignore();
             
@@ -292,17 +331,33 @@ void updateEmployee(vector<shared_ptr<Employee>>& employees) {
                 string newEmail;
                 cout << "Enter new email: ";
                 getline(cin, newEmail);
+                string oldEmail = emp->getEmail();
                 emp->setEmail(newEmail);
+                cache.onUpdate(*emp, FIELD_EMAIL, oldEmail);
             } else if (updateChoice == 2) {
                 string newPhone;
                 cout << "Enter new phone: ";
                 getline(cin, newPhone);
+                string oldPhone = emp->getPhone();
                 emp->setPhone(newPhone);
+                cache.onUpdate(*emp, FIELD_PHONE, oldPhone);
             } else if (updateChoice == 3) {
                 string newDept;
                 cout << "Enter new department: ";
                 getline(cin, newDept);
+                string oldDept = emp->getDepartment();
                 emp->setDepartment(newDept);
+                cache.onUpdate(*emp, FIELD_DEPARTMENT, oldDept);
+            } else if (updateChoice == 4) {
+                string imagePath;
+                cout << "Enter image file path: ";
+                getline(cin, imagePath);
+                string handle = blobStore.putFile(imagePath);
+                if (handle.empty()) {
+                    cout << "Could not store image " << imagePath << "!\n";
+                    return;
+                }
+                emp->setProfilePicture(handle);
             } else {
                 cout << "Invalid choice!\n";
                 return;
@@ -319,7 +374,8 @@ void updateEmployee(vector<shared_ptr<Employee>>& employees) {
     }
 }
 
-void deleteEmployee(vector<shared_ptr<Employee>>& employees) {
+void deleteEmployee(vector<shared_ptr<Employee>>& employees, SyncEngine& syncEngine,
+                    EmployeeIndex& index, QueryCache& cache) {
     string id;
     char confirm;
     
@@ -336,6 +392,9 @@ void deleteEmployee(vector<shared_ptr<Employee>>& employees) {
             cin.ignore();
             
             if (confirm == 'y' || confirm == 'Y') {
+                syncEngine.recordDelete(**it);
+                cache.onDelete(**it);
+                index.erase(id);
                 employees.erase(it);
                 cout << "Employee deleted successfully!\n";
             } else {
@@ -348,7 +407,7 @@ void deleteEmployee(vector<shared_ptr<Employee>>& employees) {
     cout << "Employee ID not found!\n";
 }
 
-void sortEmployees(vector<shared_ptr<Employee>>& employees) {
+void sortEmployees(vector<shared_ptr<Employee>>& employees, QueryCache& cache) {
     int sortChoice;
     
     cout << "\n=== SORT EMPLOYEES ===\n";
@@ -363,19 +422,19 @@ void sortEmployees(vector<shared_ptr<Employee>>& employees) {
     
     switch(sortChoice) {
         case 1:
-            sort(employees.begin(), employees.end(), compareById);
+            ThreadPool::shared().parallelSort(employees.begin(), employees.end(), compareById);
             cout << "Employees sorted by ID!\n";
             break;
         case 2:
-            sort(employees.begin(), employees.end(), compareByName);
+            ThreadPool::shared().parallelSort(employees.begin(), employees.end(), compareByName);
             cout << "Employees sorted by Name!\n";
             break;
         case 3:
-            sort(employees.begin(), employees.end(), compareByDepartment);
+            ThreadPool::shared().parallelSort(employees.begin(), employees.end(), compareByDepartment);
             cout << "Employees sorted by Department!\n";
             break;
         case 4:
-            sort(employees.begin(), employees.end(), compareByType);
+            ThreadPool::shared().parallelSort(employees.begin(), employees.end(), compareByType);
             cout << "Employees sorted by Employee Type!\n";
             break;
         default:
@@ -383,10 +442,13 @@ void sortEmployees(vector<shared_ptr<Employee>>& employees) {
             return;
     }
     
+    // Results cached in roster order are stale now
+    cache.onReorder();
     displayAllEmployees(employees);
 }
 
-void filterEmployees(const vector<shared_ptr<Employee>>& employees) {
+void filterEmployees(const vector<shared_ptr<Employee>>& employees, const EmployeeIndex& index,
+                     QueryCache& cache) {
     int filterChoice;
     
     cout << "\n=== FILTER EMPLOYEES ===\n";
@@ -404,22 +466,14 @@ void filterEmployees(const vector<shared_ptr<Employee>>& employees) {
         cout << "Enter department to filter (HR/IT/Finance/Marketing/Operations/Sales/Design/Engineering): ";
         getline(cin, dept);
         
-        for (const auto& emp : employees) {
-            if (emp->getDepartment() == dept) {
-                filteredList.push_back(emp);
-            }
-        }
+        filteredList = runQuery(Query(QUERY_DEPARTMENT, MATCH_EXACT, dept), employees, index, cache);
         cout << "\nFound " << filteredList.size() << " employees in " << dept << " department:\n";
     } else if (filterChoice == 2) {
         string type;
         cout << "Enter employee type to filter (full-time/part-time/intern): ";
         getline(cin, type);
         
-        for (const auto& emp : employees) {
-            if (emp->getEmployeeType() == type) {
-                filteredList.push_back(emp);
-            }
-        }
+        filteredList = runQuery(Query(QUERY_TYPE, MATCH_EXACT, type), employees, index, cache);
         cout << "\nFound " << filteredList.size() << " " << type << " employees:\n";
     } else {
         cout << "Invalid choice!\n";
@@ -437,36 +491,312 @@ void filterEmployees(const vector<shared_ptr<Employee>>& employees) {
              << setw(20) << "Email" << endl;
         cout << string(80, '-') << endl;
         
-        for (const auto& emp : filteredList) {
-            cout << left << setw(10) << emp->getEmployeeId()
-                 << setw(20) << emp->getFullName()
-                 << setw(15) << emp->getEmployeeType()
-                 << setw(15) << emp->getDepartment()
-                 << setw(20) << emp->getEmail() << endl;
-        }
+        cout << renderEmployeeRows(filteredList);
         cout << string(80, '-') << endl;
     }
 }
 
-// Comparison functions for sorting
-bool compareById(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-    return a->getEmployeeId() < b->getEmployeeId();
+void syncChanges(vector<shared_ptr<Employee>>& employees, SyncEngine& syncEngine,
+                 EmployeeIndex& index, QueryCache& cache) {
+    int syncChoice, formatChoice;
+    string inputFile, outputFile, remoteFile, answer;
+    
+    cout << "\n=== SYNC CHANGES TO DATABASE ===\n";
+    cout << "1. Load roster from database export\n";
+    cout << "2. Write changes\n";
+    cout << "Enter choice (1-2): ";
+    cin >> syncChoice;
+    cin.ignore();
+    
+    if (syncChoice == 1) {
+        cout << "Export file (COPY of employee_id, first_name, last_name, email, phone,\n"
+             << "gender, department, employee_type, profile_picture, created_at, updated_at): ";
+        getline(cin, inputFile);
+        
+        ifstream in(inputFile);
+        if (!in || !syncEngine.loadRoster(in, employees)) {
+            cout << "Could not read roster from " << inputFile << "!\n";
+            return;
+        }
+        
+        index.clear();
+        for (const auto& emp : employees) {
+            index[emp->getEmployeeId()] = emp;
+        }
+        cache.clear();
+        cout << "Loaded " << employees.size() << " employees. Local changes were discarded.\n";
+        return;
+    }
+    
+    if (syncChoice != 2) {
+        cout << "Invalid choice!\n";
+        return;
+    }
+    
+    cout << "Output format:\n";
+    cout << "1. SQL statements\n";
+    cout << "2. COPY stream (faster bulk inserts)\n";
+    cout << "Enter choice (1-2): ";
+    cin >> formatChoice;
+    cin.ignore();
+    
+    if (formatChoice != 1 && formatChoice != 2) {
+        cout << "Invalid choice!\n";
+        return;
+    }
+    
+    cout << "Remote state file for conflict check (leave empty to skip): ";
+    getline(cin, remoteFile);
+    
+    if (!remoteFile.empty()) {
+        ifstream remoteIn(remoteFile);
+        if (!remoteIn || !syncEngine.loadRemoteState(remoteIn)) {
+            cout << "Could not read remote state from " << remoteFile << "!\n";
+            return;
+        }
+        if (syncEngine.confirmedCount() > 0) {
+            cout << "Confirmed " << syncEngine.confirmedCount()
+                 << " changes from the previous sync.\n";
+        }
+    }
+    
+    cout << "Output file (e.g., changes.sql): ";
+    getline(cin, outputFile);
+    
+    ofstream out(outputFile);
+    if (!out) {
+        cout << "Could not open " << outputFile << " for writing!\n";
+        return;
+    }
+    
+    SyncReport report = syncEngine.sync(employees, out,
+                                        formatChoice == 2 ? SYNC_COPY : SYNC_SQL);
+    out.close();
+    
+    cout << "\nInserted: " << report.inserted << endl;
+    cout << "Updated:  " << report.updated << endl;
+    cout << "Deleted:  " << report.deleted << endl;
+    
+    if (!report.conflicts.empty()) {
+        cout << "Skipped " << report.conflicts.size()
+             << " employees changed in (or not loaded from) the database:\n";
+        for (const auto& id : report.conflicts) {
+            cout << "  " << id << endl;
+        }
+    }
+    
+    if (!syncEngine.hasUnconfirmed()) {
+        cout << "Nothing to write.\n";
+        return;
+    }
+    cout << "Changes written to " << outputFile << endl;
+    
+    cout << "A row changed by someone else makes the script roll back (sync conflict).\n";
+    cout << "Did the script commit? (y = yes, n = no, other = check on next sync): ";
+    getline(cin, answer);
+    
+    if (answer == "y" || answer == "Y") {
+        syncEngine.acknowledge();
+        cout << "Changes marked as synced.\n";
+    } else if (answer == "n" || answer == "N") {
+        syncEngine.discardUnconfirmed();
+        cout << "Changes kept for the next sync.\n";
+    } else {
+        cout << "Changes stay pending until a remote state file confirms them.\n";
+    }
 }
 
-bool compareByName(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-    return a->getFullName() < b->getFullName();
+// Microseconds taken by fn, best of a few runs
+template<typename Fn>
+double timeMicros(Fn fn) {
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        best = (run == 0 || micros < best) ? micros : best;
+    }
+    return best;
 }
 
-bool compareByDepartment(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-    if (a->getDepartment() == b->getDepartment()) {
-        return compareByName(a, b);
+void storageReport(const vector<shared_ptr<Employee>>& employees) {
+    cout << "\n=== STORAGE REPORT ===\n";
+    
+    if (employees.empty()) {
+        cout << "No employees found!\n";
+        return;
+    }
+    
+    CompactRoster compact;
+    compact.build(employees);
+    
+    size_t regularBytes = CompactRoster::estimateRosterBytes(employees);
+    size_t compactBytes = compact.bytesUsed();
+    size_t count = employees.size();
+    
+    cout << left << setw(20) << "Layout"
+         << setw(15) << "Total bytes"
+         << setw(15) << "Bytes/employee" << endl;
+    cout << string(50, '-') << endl;
+    cout << left << setw(20) << "Regular"
+         << setw(15) << regularBytes
+         << setw(15) << regularBytes / count << endl;
+    cout << left << setw(20) << "Compact"
+         << setw(15) << compactBytes
+         << setw(15) << compactBytes / count << endl;
+    cout << string(50, '-') << endl;
+    
+    // Probe with the first employee's values so every lookup finds something.
+    // Each timed loop keeps its result and the table prints it, so none of
+    // them can be optimised away.
+    const Employee& probe = *employees.front();
+    string fname = probe.getFirstName(), lname = probe.getLastName();
+    string dept = probe.getDepartment(), type = probe.getEmployeeType();
+    size_t regularNameFound = 0, compactNameFound = 0;
+    size_t regularDeptFound = 0, compactDeptFound = 0;
+    size_t regularTypeFound = 0, compactTypeFound = 0;
+    
+    double regularName = timeMicros([&] {
+        regularNameFound = 0;
+        for (const auto& emp : employees) {
+            regularNameFound += emp->getFirstName() == fname && emp->getLastName() == lname;
+        }
+    });
+    double compactName = timeMicros([&] { compactNameFound = compact.findByName(fname, lname).size(); });
+    
+    double regularDept = timeMicros([&] {
+        regularDeptFound = 0;
+        for (const auto& emp : employees) {
+            regularDeptFound += emp->getDepartment() == dept;
+        }
+    });
+    double compactDept = timeMicros([&] { compactDeptFound = compact.filterByDepartment(dept).size(); });
+    
+    double regularType = timeMicros([&] {
+        regularTypeFound = 0;
+        for (const auto& emp : employees) {
+            regularTypeFound += emp->getEmployeeType() == type;
+        }
+    });
+    double compactType = timeMicros([&] { compactTypeFound = compact.filterByType(type).size(); });
+    
+    // Reading every email: a field access on one side, a decode on the other
+    size_t regularChars = 0, compactChars = 0;
+    double regularRead = timeMicros([&] {
+        regularChars = 0;
+        for (const auto& emp : employees) {
+            regularChars += emp->getEmail().size();
+        }
+    });
+    double compactRead = timeMicros([&] {
+        compactChars = 0;
+        for (size_t i = 0; i < compact.size(); i++) {
+            compactChars += compact.getEmail(i).size();
+        }
+    });
+    
+    auto result = [](size_t regular, size_t compactResult, const string& unit) {
+        string text = to_string(regular);
+        if (compactResult != regular) {
+            text += " vs " + to_string(compactResult);
+        }
+        return text + " " + unit;
+    };
+    
+    cout << "\nLookup times (microseconds, best of 5):\n";
+    cout << left << setw(20) << "Operation"
+         << setw(15) << "Regular"
+         << setw(15) << "Compact"
+         << "Result" << endl;
+    cout << string(65, '-') << endl;
+    cout << fixed << setprecision(1);
+    cout << left << setw(20) << "Find by name" << setw(15) << regularName << setw(15) << compactName
+         << result(regularNameFound, compactNameFound, "found") << endl;
+    cout << left << setw(20) << "Filter department" << setw(15) << regularDept << setw(15) << compactDept
+         << result(regularDeptFound, compactDeptFound, "found") << endl;
+    cout << left << setw(20) << "Filter type" << setw(15) << regularType << setw(15) << compactType
+         << result(regularTypeFound, compactTypeFound, "found") << endl;
+    cout << left << setw(20) << "Read all emails" << setw(15) << regularRead << setw(15) << compactRead
+         << result(regularChars, compactChars, "chars") << endl;
+    cout << defaultfloat << string(65, '-') << endl;
+    
+    vector<size_t> matches = compact.findByName(fname, lname);
+    if (!matches.empty()) {
+        cout << "\nFirst record as decoded from the compact layout:";
+        compact.displayDetails(matches.front());
     }
-    return a->getDepartment() < b->getDepartment();
+    
+    cout << "The compact layout is built here only to be measured; the roster\n";
+    cout << "itself stays in the regular layout. Its dictionaries add fixed\n";
+    cout << "overhead, so it pays off on large rosters.\n";
 }
 
-bool compareByType(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
-    if (a->getEmployeeType() == b->getEmployeeType()) {
-        return compareByName(a, b);
+void exportProfilePicture(const vector<shared_ptr<Employee>>& employees, BlobStore& blobStore) {
+    string id, outputFile;
+    
+    cout << "\n=== EXPORT PROFILE PICTURE ===\n";
+    cout << "Enter Employee ID: ";
+    getline(cin, id);
+    
+    auto it = find_if(employees.begin(), employees.end(),
+                      [&](const shared_ptr<Employee>& emp) { return emp->getEmployeeId() == id; });
+    if (it == employees.end()) {
+        cout << "Employee ID not found!\n";
+        return;
+    }
+    
+    string handle = (*it)->getProfilePicture();
+    if (handle.empty() || !blobStore.contains(handle)) {
+        cout << "No profile picture stored for " << id << "!\n";
+        return;
+    }
+    
+    cout << "Output file (e.g., picture.jpg): ";
+    getline(cin, outputFile);
+    
+    ofstream out(outputFile, ios::binary);
+    if (!out || !blobStore.writeTo(handle, out)) {
+        cout << "Could not write " << outputFile << "!\n";
+        return;
     }
-    return a->getEmployeeType() < b->getEmployeeType();
-}
\ No newline at end of file
+    
+    cout << "Profile picture written to " << outputFile << endl;
+    cout << "Picture cache in use: " << blobStore.cachedBytes() / 1024 << " KB\n";
+}
+
+// Format the table rows for a list of employees, chunks rendered in parallel
+string renderEmployeeRows(const vector<shared_ptr<Employee>>& employees) {
+    return ThreadPool::shared().parallelReduce(0, employees.size(), SCAN_GRAIN, string(),
+        [&](size_t lo, size_t hi) {
+            ostringstream rows;
+            for (size_t i = lo; i < hi; i++) {
+                const auto& emp = employees[i];
+                rows << left << setw(10) << emp->getEmployeeId()
+                     << setw(20) << emp->getFullName()
+                     << setw(15) << emp->getEmployeeType()
+                     << setw(15) << emp->getDepartment()
+                     << setw(20) << emp->getEmail() << "\n";
+            }
+            return rows.str();
+        },
+        [](string result, string chunk) {
+            result += chunk;
+            return result;
+        });
+}
+
+void cacheReport(const QueryCache& cache) {
+    QueryCacheStats stats = cache.stats();
+    size_t lookups = stats.hits + stats.misses;
+    
+    cout << "\n=== QUERY CACHE STATISTICS ===\n";
+    cout << "Hits:           " << stats.hits << endl;
+    cout << "Misses:         " << stats.misses << endl;
+    cout << "Hit Rate:       " << fixed << setprecision(1)
+         << (lookups > 0 ? 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0)
+         << "%" << endl;
+    cout << "Invalidations:  " << stats.invalidations << endl;
+    cout << "Evictions:      " << stats.evictions << endl;
+    cout << "Cached Queries: " << stats.entries << endl;
+    cout << "Memory Used:    " << stats.bytes << " bytes" << endl;
+}
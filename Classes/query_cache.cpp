@@ -0,0 +1,284 @@
+#include "query_cache.h"
+#include "thread_pool.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+// ==================== QUERY ====================
+
+Query::Query(QueryField field, QueryMatch match, string term,
+             QuerySort sort, size_t offset, size_t limit)
+    : field(field), match(match), term(term), sort(sort), offset(offset), limit(limit) {
+}
+
+string Query::key() const {
+    // Length-prefixed term so no term can collide with another key
+    ostringstream oss;
+    oss << field << '|' << match << '|' << sort << '|'
+        << offset << '|' << limit << '|' << term.size() << ':' << term;
+    return oss.str();
+}
+
+static bool matchValue(QueryMatch match, const string& value, const string& term) {
+    if (match == MATCH_EXACT) {
+        return value == term;
+    }
+    return value.find(term) != string::npos;
+}
+
+bool Query::matches(const Employee& emp) const {
+    return matchesWith(emp, 0, "");
+}
+
+bool Query::matchesWith(const Employee& emp, unsigned changed, const string& value) const {
+    switch(field) {
+        case QUERY_EMPLOYEE_ID:
+            return matchValue(match, emp.getEmployeeId(), term);
+        case QUERY_NAME: {
+            string fname = changed == FIELD_FIRST_NAME ? value : emp.getFirstName();
+            string lname = changed == FIELD_LAST_NAME ? value : emp.getLastName();
+            return matchValue(match, fname + " " + lname, term);
+        }
+        case QUERY_DEPARTMENT:
+            return matchValue(match, changed == FIELD_DEPARTMENT ? value : emp.getDepartment(), term);
+        case QUERY_TYPE:
+            return matchValue(match, changed == FIELD_EMPLOYEE_TYPE ? value : emp.getEmployeeType(), term);
+    }
+    return false;
+}
+
+unsigned Query::fieldsRead() const {
+    const unsigned nameFields = FIELD_FIRST_NAME | FIELD_LAST_NAME;
+    unsigned fields = 0;
+
+    switch(field) {
+        case QUERY_EMPLOYEE_ID: break; // IDs never change
+        case QUERY_NAME:        fields |= nameFields; break;
+        case QUERY_DEPARTMENT:  fields |= FIELD_DEPARTMENT; break;
+        case QUERY_TYPE:        fields |= FIELD_EMPLOYEE_TYPE; break;
+    }
+
+    // Department and type orders break ties by name
+    switch(sort) {
+        case SORT_NONE:       break;
+        case SORT_ID:         break;
+        case SORT_NAME:       fields |= nameFields; break;
+        case SORT_DEPARTMENT: fields |= FIELD_DEPARTMENT | nameFields; break;
+        case SORT_TYPE:       fields |= FIELD_EMPLOYEE_TYPE | nameFields; break;
+    }
+    return fields;
+}
+
+// ==================== QUERY CACHE ====================
+
+QueryCache::QueryCache(size_t memoryLimit)
+    : memoryLimit(memoryLimit), memoryUsed(0),
+      hits(0), misses(0), invalidations(0), evictions(0) {
+}
+
+bool QueryCache::lookup(const Query& query, vector<string>& ids) {
+    auto it = entries.find(query.key());
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    ids = it->second.ids;
+    return true;
+}
+
+void QueryCache::store(const Query& query, vector<string> ids) {
+    string key = query.key();
+
+    auto existing = entries.find(key);
+    if (existing != entries.end()) {
+        erase(existing);
+    }
+
+    size_t bytes = sizeof(Entry) + 2 * key.size() + query.term.size() +
+                   ids.capacity() * sizeof(string);
+    for (const auto& id : ids) {
+        bytes += id.size() > 15 ? id.size() + 1 : 0;
+    }
+    if (bytes > memoryLimit) {
+        return;
+    }
+
+    lru.push_front(key);
+    Entry entry = { query, move(ids), bytes, lru.begin() };
+    entries.emplace(key, move(entry));
+    memoryUsed += bytes;
+    evict();
+}
+
+void QueryCache::erase(unordered_map<string, Entry>::iterator it) {
+    memoryUsed -= it->second.bytes;
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+}
+
+void QueryCache::evict() {
+    while (memoryUsed > memoryLimit && !lru.empty()) {
+        erase(entries.find(lru.back()));
+        evictions++;
+    }
+}
+
+// A new or removed record changes every result it belongs to
+void QueryCache::onAdd(const Employee& emp) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.query.matches(emp)) {
+            erase(it++);
+            invalidations++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QueryCache::onDelete(const Employee& emp) {
+    onAdd(emp);
+}
+
+void QueryCache::onUpdate(const Employee& emp, unsigned field, const string& oldValue) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        const Query& query = it->second.query;
+        if ((query.fieldsRead() & field) &&
+            (query.matches(emp) || query.matchesWith(emp, field, oldValue))) {
+            erase(it++);
+            invalidations++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QueryCache::onReorder() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.query.sort == SORT_NONE) {
+            erase(it++);
+            invalidations++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QueryCache::clear() {
+    entries.clear();
+    lru.clear();
+    memoryUsed = 0;
+}
+
+QueryCacheStats QueryCache::stats() const {
+    QueryCacheStats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.invalidations = invalidations;
+    s.evictions = evictions;
+    s.entries = entries.size();
+    s.bytes = memoryUsed;
+    return s;
+}
+
+// ==================== RUNNING QUERIES ====================
+
+// Collect matching employees in roster order, scanning chunks in parallel
+template<typename Pred>
+static vector<shared_ptr<Employee>> parallelFilter(const vector<shared_ptr<Employee>>& employees, Pred pred) {
+    typedef vector<shared_ptr<Employee>> EmployeeList;
+
+    return ThreadPool::shared().parallelReduce(0, employees.size(), SCAN_GRAIN, EmployeeList(),
+        [&](size_t lo, size_t hi) {
+            EmployeeList chunk;
+            for (size_t i = lo; i < hi; i++) {
+                if (pred(employees[i])) {
+                    chunk.push_back(employees[i]);
+                }
+            }
+            return chunk;
+        },
+        [](EmployeeList result, EmployeeList chunk) {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+            return result;
+        });
+}
+
+// Answer a search/filter from the cache, or scan the roster and cache the IDs
+vector<shared_ptr<Employee>> runQuery(const Query& query, const vector<shared_ptr<Employee>>& employees,
+                                      const EmployeeIndex& index, QueryCache& cache) {
+    vector<string> ids;
+    vector<shared_ptr<Employee>> results;
+
+    if (cache.lookup(query, ids)) {
+        for (const auto& id : ids) {
+            auto it = index.find(id);
+            if (it != index.end()) {
+                results.push_back(it->second);
+            }
+        }
+        return results;
+    }
+
+    results = parallelFilter(employees, [&](const shared_ptr<Employee>& emp) {
+        return query.matches(*emp);
+    });
+
+    switch(query.sort) {
+        case SORT_NONE:
+            break;
+        case SORT_ID:
+            ThreadPool::shared().parallelSort(results.begin(), results.end(), compareById);
+            break;
+        case SORT_NAME:
+            ThreadPool::shared().parallelSort(results.begin(), results.end(), compareByName);
+            break;
+        case SORT_DEPARTMENT:
+            ThreadPool::shared().parallelSort(results.begin(), results.end(), compareByDepartment);
+            break;
+        case SORT_TYPE:
+            ThreadPool::shared().parallelSort(results.begin(), results.end(), compareByType);
+            break;
+    }
+
+    if (query.offset > 0 || query.limit > 0) {
+        size_t from = min(query.offset, results.size());
+        size_t to = query.limit > 0 ? min(results.size(), from + query.limit) : results.size();
+        results = vector<shared_ptr<Employee>>(results.begin() + static_cast<ptrdiff_t>(from),
+                                               results.begin() + static_cast<ptrdiff_t>(to));
+    }
+
+    ids.reserve(results.size());
+    for (const auto& emp : results) {
+        ids.push_back(emp->getEmployeeId());
+    }
+    cache.store(query, move(ids));
+    return results;
+}
+
+// Comparison functions for sorting
+bool compareById(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
+    return a->getEmployeeId() < b->getEmployeeId();
+}
+
+bool compareByName(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
+    return a->getFullName() < b->getFullName();
+}
+
+bool compareByDepartment(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
+    if (a->getDepartment() == b->getDepartment()) {
+        return compareByName(a, b);
+    }
+    return a->getDepartment() < b->getDepartment();
+}
+
+bool compareByType(const shared_ptr<Employee>& a, const shared_ptr<Employee>& b) {
+    if (a->getEmployeeType() == b->getEmployeeType()) {
+        return compareByName(a, b);
+    }
+    return a->getEmployeeType() < b->getEmployeeType();
+}
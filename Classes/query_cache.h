@@ -0,0 +1,128 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include "employee.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <cstddef>
+
+// Field a query filters on
+enum QueryField {
+    QUERY_EMPLOYEE_ID,
+    QUERY_NAME,
+    QUERY_DEPARTMENT,
+    QUERY_TYPE
+};
+
+enum QueryMatch {
+    MATCH_EXACT,
+    MATCH_CONTAINS
+};
+
+// Result order; SORT_NONE keeps the roster's current order
+enum QuerySort {
+    SORT_NONE,
+    SORT_ID,
+    SORT_NAME,
+    SORT_DEPARTMENT,
+    SORT_TYPE
+};
+
+// A search or filter as issued by the menu or the dashboard
+struct Query {
+    QueryField field;
+    QueryMatch match;
+    std::string term;
+    QuerySort sort;
+    size_t offset;
+    size_t limit; // 0 = no limit
+
+    Query(QueryField field, QueryMatch match, std::string term,
+          QuerySort sort = SORT_NONE, size_t offset = 0, size_t limit = 0);
+
+    // Canonical cache key covering criteria, sort and page
+    std::string key() const;
+
+    bool matches(const Employee& emp) const;
+
+    // Same check with one field replaced, to test a record's state before an update
+    bool matchesWith(const Employee& emp, unsigned field, const std::string& value) const;
+
+    // EmployeeField bits the criteria and sort order depend on
+    unsigned fieldsRead() const;
+};
+
+struct QueryCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t invalidations;
+    size_t evictions;
+    size_t entries;
+    size_t bytes;
+};
+
+// Caches the employee IDs returned by a query. Mutations invalidate only
+// the entries whose result could have changed: those the record matched
+// before or after the change, and for updates only if the changed field
+// is one the query filters or sorts on. Entries are evicted least
+// recently used first once the memory bound is exceeded.
+class QueryCache {
+private:
+    struct Entry {
+        Query query;
+        std::vector<std::string> ids;
+        size_t bytes;
+        std::list<std::string>::iterator lruPos;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru; // most recently used first
+    size_t memoryLimit;
+    size_t memoryUsed;
+    size_t hits;
+    size_t misses;
+    size_t invalidations;
+    size_t evictions;
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+    void evict();
+
+public:
+    explicit QueryCache(size_t memoryLimit = 4 * 1024 * 1024);
+
+    // True on a hit, with the cached IDs copied into ids
+    bool lookup(const Query& query, std::vector<std::string>& ids);
+    void store(const Query& query, std::vector<std::string> ids);
+
+    // Mutation hooks, called by the add/update/delete paths
+    void onAdd(const Employee& emp);
+    void onUpdate(const Employee& emp, unsigned field, const std::string& oldValue);
+    void onDelete(const Employee& emp);
+    void onReorder(); // roster order changed, e.g. after sorting
+
+    void clear();
+    QueryCacheStats stats() const;
+};
+
+// Employee ID -> employee, used to resolve cached query results
+typedef std::unordered_map<std::string, std::shared_ptr<Employee>> EmployeeIndex;
+
+// Records per task for parallel scans
+const size_t SCAN_GRAIN = 4096;
+
+// Answer a query from the cache, or scan, sort and page the roster and
+// cache the resulting IDs
+std::vector<std::shared_ptr<Employee>> runQuery(const Query& query,
+                                                const std::vector<std::shared_ptr<Employee>>& employees,
+                                                const EmployeeIndex& index, QueryCache& cache);
+
+// Orders used by the sort menu and by sorted queries
+bool compareById(const std::shared_ptr<Employee>& a, const std::shared_ptr<Employee>& b);
+bool compareByName(const std::shared_ptr<Employee>& a, const std::shared_ptr<Employee>& b);
+bool compareByDepartment(const std::shared_ptr<Employee>& a, const std::shared_ptr<Employee>& b);
+bool compareByType(const std::shared_ptr<Employee>& a, const std::shared_ptr<Employee>& b);
+
+#endif // QUERY_CACHE_H
@@ -0,0 +1,604 @@
+#include "sync.h"
+#include "thread_pool.h"
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std;
+
+// Column for every dirty bit, in table order
+struct SyncColumn {
+    unsigned field;
+    const char* name;
+    string (Employee::*getter)() const;
+};
+
+static const SyncColumn SYNC_COLUMNS[] = {
+    { FIELD_FIRST_NAME,      "first_name",      &Employee::getFirstName },
+    { FIELD_LAST_NAME,       "last_name",       &Employee::getLastName },
+    { FIELD_EMAIL,           "email",           &Employee::getEmail },
+    { FIELD_PHONE,           "phone",           &Employee::getPhone },
+    { FIELD_GENDER,          "gender",          &Employee::getGender },
+    { FIELD_DEPARTMENT,      "department",      &Employee::getDepartment },
+    { FIELD_EMPLOYEE_TYPE,   "employee_type",   &Employee::getEmployeeType },
+    { FIELD_PROFILE_PICTURE, "profile_picture", &Employee::getProfilePicture }
+};
+
+// Render the batches of [0, count) on the thread pool and write them in
+// order. Only a window of a few batches per thread is held in memory.
+static void writeBatches(size_t count, size_t batchSize, ostream& out,
+                         const function<void(size_t, size_t, ostream&)>& render) {
+    ThreadPool& pool = ThreadPool::shared();
+    size_t batches = (count + batchSize - 1) / batchSize;
+    size_t window = (pool.size() + 1) * 2;
+    vector<string> rendered(min(batches, window));
+
+    for (size_t first = 0; first < batches; first += window) {
+        size_t last = min(batches, first + window);
+        pool.parallelFor(first, last, 1, [&](size_t lo, size_t hi) {
+            for (size_t b = lo; b < hi; b++) {
+                ostringstream batch;
+                render(b * batchSize, min(count, (b + 1) * batchSize), batch);
+                rendered[b - first] = batch.str();
+            }
+        });
+
+        for (size_t b = first; b < last; b++) {
+            out << rendered[b - first];
+            rendered[b - first].clear();
+        }
+    }
+}
+
+// profile_picture holds the image inline, as the web form writes it
+static bool columnValue(BlobStore& pictures, const SyncColumn& col, const Employee& emp,
+                        string& value) {
+    value = (emp.*col.getter)();
+    if (col.field != FIELD_PROFILE_PICTURE) {
+        return true;
+    }
+    if (!value.empty()) {
+        value = pictures.dataUriFor(value);
+    }
+    return !value.empty();
+}
+
+// Quoted literal, or NULL for a missing picture
+static string sqlValue(BlobStore& pictures, const SyncColumn& col, const Employee& emp) {
+    string value;
+    return columnValue(pictures, col, emp, value) ? SyncEngine::quoteLiteral(value) : "NULL";
+}
+
+static string copyValue(BlobStore& pictures, const SyncColumn& col, const Employee& emp) {
+    string value;
+    return columnValue(pictures, col, emp, value) ? SyncEngine::escapeCopy(value) : "\\N";
+}
+
+SyncEngine::SyncEngine(BlobStore& pictures, size_t batchSize)
+    : unconfirmedStamp(0), lastStamp(0), lastConfirmed(0), pictures(pictures) {
+    this->batchSize = batchSize > 0 ? batchSize : 1;
+}
+
+void SyncEngine::recordDelete(const Employee& emp) {
+    string id = emp.getEmployeeId();
+    SyncTime base;
+    // Rows that never reached the database have nothing to delete
+    if (emp.isPersisted() || baseFor(id, base)) {
+        pendingDeletes.insert(id);
+    }
+}
+
+bool SyncEngine::loadRoster(istream& in, vector<shared_ptr<Employee>>& employees) {
+    const size_t COLUMNS = 11;
+    vector<shared_ptr<Employee>> loaded;
+    map<string, SyncTime> updated;
+    int maxNumber = 0;
+    string line;
+
+    while (getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        vector<string> fields;
+        size_t start = 0;
+        for (size_t tab = line.find('\t'); ; tab = line.find('\t', start)) {
+            string field = line.substr(start, tab == string::npos ? string::npos : tab - start);
+            fields.push_back(field == "\\N" ? "" : unescapeCopy(field));
+            if (tab == string::npos) {
+                break;
+            }
+            start = tab + 1;
+        }
+
+        SyncTime createdAt, updatedAt;
+        if (fields.size() != COLUMNS || fields[0].empty() ||
+            !parseTimestamp(fields[9], createdAt) || !parseTimestamp(fields[10], updatedAt)) {
+            return false;
+        }
+
+        auto emp = make_shared<Employee>(fields[1], fields[2], fields[3], fields[4],
+                                         fields[5], fields[6], fields[7]);
+        emp->setEmployeeId(fields[0]);
+        emp->setProfilePicture(pictures.putDataUri(fields[8]));
+        emp->setTimestamps(toTimeT(createdAt), toTimeT(updatedAt));
+        emp->markClean();
+        loaded.push_back(emp);
+        updated[fields[0]] = updatedAt;
+
+        if (fields[0].compare(0, 3, "EMP") == 0) {
+            maxNumber = max(maxNumber, atoi(fields[0].c_str() + 3));
+        }
+    }
+
+    employees.swap(loaded);
+    Employee::setCounter(maxNumber);
+
+    baseline = updated;
+    remoteState = updated;
+    pendingDeletes.clear();
+    unconfirmedRows.clear();
+    unconfirmedDeletes.clear();
+    for (const auto& entry : updated) {
+        lastStamp = max(lastStamp, entry.second);
+    }
+    return true;
+}
+
+bool SyncEngine::loadRemoteState(istream& in) {
+    map<string, SyncTime> state;
+    string line;
+
+    while (getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        size_t tab = line.find('\t');
+        SyncTime updated;
+        if (tab == string::npos || !parseTimestamp(line.substr(tab + 1), updated)) {
+            return false;
+        }
+        state[line.substr(0, tab)] = updated;
+        // New stamps must sort after anything the database already holds
+        lastStamp = max(lastStamp, updated);
+    }
+
+    remoteState.swap(state);
+
+    // Rows carrying our stamp made it; anything else is written again
+    lastConfirmed = 0;
+    for (const auto& row : unconfirmedRows) {
+        auto remote = remoteState.find(row.emp->getEmployeeId());
+        if (remote != remoteState.end() && remote->second == unconfirmedStamp) {
+            confirmRow(row);
+        }
+    }
+    for (const auto& id : unconfirmedDeletes) {
+        if (!remoteState.count(id)) {
+            baseline.erase(id);
+            pendingDeletes.erase(id);
+            lastConfirmed++;
+        }
+    }
+    unconfirmedRows.clear();
+    unconfirmedDeletes.clear();
+    return true;
+}
+
+void SyncEngine::confirmRow(const PendingRow& row) {
+    // Changes made after the write are still owed to the database
+    bool unchanged = row.emp->getRevision() == row.revision;
+    row.emp->markClean(unchanged ? FIELD_ALL : 0);
+    baseline[row.emp->getEmployeeId()] = unconfirmedStamp;
+    remoteState[row.emp->getEmployeeId()] = unconfirmedStamp;
+    lastConfirmed++;
+}
+
+void SyncEngine::acknowledge() {
+    lastConfirmed = 0;
+    for (const auto& row : unconfirmedRows) {
+        confirmRow(row);
+    }
+    for (const auto& id : unconfirmedDeletes) {
+        baseline.erase(id);
+        remoteState.erase(id);
+        pendingDeletes.erase(id);
+        lastConfirmed++;
+    }
+    unconfirmedRows.clear();
+    unconfirmedDeletes.clear();
+}
+
+void SyncEngine::discardUnconfirmed() {
+    unconfirmedRows.clear();
+    unconfirmedDeletes.clear();
+}
+
+bool SyncEngine::hasUnconfirmed() const {
+    return !unconfirmedRows.empty() || !unconfirmedDeletes.empty();
+}
+
+bool SyncEngine::hasConflict(const string& id) const {
+    auto remote = remoteState.find(id);
+    if (remote == remoteState.end()) {
+        return false;
+    }
+    SyncTime base;
+    if (!baseFor(id, base)) {
+        // Present remotely but never synced from here: someone else owns it
+        return true;
+    }
+    // Other writers get the server's clock, which may be behind ours
+    return remote->second != base;
+}
+
+// updated_at the database should hold for a row we wrote
+bool SyncEngine::baseFor(const string& id, SyncTime& base) const {
+    auto known = baseline.find(id);
+    if (known != baseline.end()) {
+        base = known->second;
+        return true;
+    }
+    for (const auto& row : unconfirmedRows) {
+        if (row.emp->getEmployeeId() == id) {
+            base = unconfirmedStamp;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Current local time, strictly after every stamp seen so far
+SyncTime SyncEngine::nextStamp() {
+    using namespace std::chrono;
+    system_clock::time_point now = system_clock::now();
+    time_t seconds = system_clock::to_time_t(now);
+    long long micros = duration_cast<microseconds>(now - system_clock::from_time_t(seconds)).count();
+    lastStamp = max(toSyncTime(seconds) + micros, lastStamp + 1);
+    return lastStamp;
+}
+
+SyncReport SyncEngine::sync(vector<shared_ptr<Employee>>& employees,
+                            ostream& out, SyncFormat format) {
+    SyncReport report;
+    vector<pair<string, SyncTime>> deletes;      // rows we know the database holds
+    vector<pair<string, SyncTime>> maybeDeletes; // rows an unconfirmed run may have inserted
+    vector<shared_ptr<Employee>> inserts;
+    map<unsigned, vector<shared_ptr<Employee>>> updates; // grouped by dirty mask
+
+    // Conflicting deletes stay pending so they can be retried
+    for (auto it = pendingDeletes.begin(); it != pendingDeletes.end();) {
+        SyncTime base;
+        if (hasConflict(*it)) {
+            report.conflicts.push_back(*it);
+            ++it;
+        } else if (baseFor(*it, base)) {
+            (baseline.count(*it) ? deletes : maybeDeletes).push_back(make_pair(*it, base));
+            ++it;
+        } else {
+            it = pendingDeletes.erase(it);
+        }
+    }
+
+    // An unconfirmed previous run counts as not applied
+    discardUnconfirmed();
+
+    for (const auto& emp : employees) {
+        if (!emp->isDirty()) {
+            continue;
+        }
+        SyncTime base;
+        if (hasConflict(emp->getEmployeeId()) ||
+            (emp->isPersisted() && !baseFor(emp->getEmployeeId(), base))) {
+            report.conflicts.push_back(emp->getEmployeeId());
+        } else if (!emp->isPersisted()) {
+            inserts.push_back(emp);
+        } else {
+            updates[emp->getDirtyFields()].push_back(emp);
+        }
+    }
+
+    if (deletes.empty() && maybeDeletes.empty() && inserts.empty() && updates.empty()) {
+        return report;
+    }
+
+    report.stamp = nextStamp();
+
+    out << "BEGIN;\n";
+    writeDeletes(deletes, true, out);
+    writeDeletes(maybeDeletes, false, out);
+    writeInserts(inserts, report.stamp, out, format);
+    for (const auto& group : updates) {
+        writeUpdates(group.first, group.second, report.stamp, out);
+    }
+    out << "COMMIT;\n";
+
+    // Records stay dirty until acknowledge() or loadRemoteState() confirms them
+    unconfirmedStamp = report.stamp;
+    for (const auto& entry : deletes) {
+        unconfirmedDeletes.push_back(entry.first);
+    }
+    for (const auto& entry : maybeDeletes) {
+        unconfirmedDeletes.push_back(entry.first);
+    }
+    for (const auto& emp : inserts) {
+        unconfirmedRows.push_back({ emp, emp->getRevision() });
+    }
+    for (const auto& group : updates) {
+        for (const auto& emp : group.second) {
+            unconfirmedRows.push_back({ emp, emp->getRevision() });
+        }
+        report.updated += group.second.size();
+    }
+
+    report.inserted = inserts.size();
+    report.deleted = deletes.size() + maybeDeletes.size();
+    return report;
+}
+
+void SyncEngine::writeInserts(const vector<shared_ptr<Employee>>& rows, SyncTime stamp,
+                              ostream& out, SyncFormat format) const {
+    if (rows.empty()) {
+        return;
+    }
+
+    ostringstream columns;
+    columns << "employee_id";
+    for (const auto& col : SYNC_COLUMNS) {
+        columns << ", " << col.name;
+    }
+    columns << ", created_at, updated_at";
+    string updatedAt = formatTimestamp(stamp);
+
+    if (format == SYNC_COPY) {
+        out << "COPY employees (" << columns.str() << ") FROM STDIN;\n";
+        writeBatches(rows.size(), batchSize, out, [&](size_t start, size_t end, ostream& batch) {
+            for (size_t i = start; i < end; i++) {
+                const Employee& emp = *rows[i];
+                batch << escapeCopy(emp.getEmployeeId());
+                for (const auto& col : SYNC_COLUMNS) {
+                    batch << '\t' << copyValue(pictures, col, emp);
+                }
+                batch << '\t' << formatTimestamp(toSyncTime(emp.getCreatedAt()))
+                      << '\t' << updatedAt << '\n';
+            }
+        });
+        out << "\\.\n";
+        return;
+    }
+
+    writeBatches(rows.size(), batchSize, out, [&](size_t start, size_t end, ostream& batch) {
+        batch << "INSERT INTO employees (" << columns.str() << ") VALUES\n";
+        for (size_t i = start; i < end; i++) {
+            const Employee& emp = *rows[i];
+            batch << "    (" << quoteLiteral(emp.getEmployeeId());
+            for (const auto& col : SYNC_COLUMNS) {
+                batch << ", " << sqlValue(pictures, col, emp);
+            }
+            batch << ", " << quoteLiteral(formatTimestamp(toSyncTime(emp.getCreatedAt())))
+                  << ", " << quoteLiteral(updatedAt) << ")"
+                  << (i + 1 < end ? ",\n" : ";\n");
+        }
+    });
+}
+
+void SyncEngine::writeUpdates(unsigned fields, const vector<shared_ptr<Employee>>& rows,
+                              SyncTime stamp, ostream& out) const {
+    vector<const SyncColumn*> changed;
+    for (const auto& col : SYNC_COLUMNS) {
+        if (fields & col.field) {
+            changed.push_back(&col);
+        }
+    }
+
+    writeBatches(rows.size(), batchSize, out, [&](size_t start, size_t end, ostream& batch) {
+        batch << "WITH changed AS (\nUPDATE employees AS e SET ";
+        for (const auto* col : changed) {
+            batch << col->name << " = v." << col->name << ", ";
+        }
+        batch << "updated_at = " << quoteLiteral(formatTimestamp(stamp)) << "::timestamp"
+              << "\nFROM (VALUES\n";
+        for (size_t i = start; i < end; i++) {
+            const Employee& emp = *rows[i];
+            SyncTime base = 0;
+            baseFor(emp.getEmployeeId(), base);
+            batch << "    (" << quoteLiteral(emp.getEmployeeId());
+            for (const auto* col : changed) {
+                batch << ", " << sqlValue(pictures, *col, emp);
+            }
+            batch << ", " << quoteLiteral(formatTimestamp(base)) << "::timestamp)"
+                  << (i + 1 < end ? ",\n" : "\n");
+        }
+        batch << ") AS v(employee_id";
+        for (const auto* col : changed) {
+            batch << ", " << col->name;
+        }
+        batch << ", base_updated_at)\n"
+              << "WHERE e.employee_id = v.employee_id AND e.updated_at = v.base_updated_at\n"
+              << "RETURNING 1\n)\n"
+              << "SELECT sync_expect_rows(" << end - start << ", count(*), 'UPDATE') FROM changed;\n";
+    });
+}
+
+// Strict deletes abort the script unless every row is still as we left
+// it; the others only remove rows that carry the given stamp, if any
+void SyncEngine::writeDeletes(const vector<pair<string, SyncTime>>& rows, bool strict,
+                              ostream& out) const {
+    writeBatches(rows.size(), batchSize, out, [&](size_t start, size_t end, ostream& batch) {
+        if (strict) {
+            batch << "WITH removed AS (\n";
+        }
+        batch << "DELETE FROM employees AS e USING (VALUES\n";
+        for (size_t i = start; i < end; i++) {
+            batch << "    (" << quoteLiteral(rows[i].first) << ", "
+                  << quoteLiteral(formatTimestamp(rows[i].second)) << "::timestamp)"
+                  << (i + 1 < end ? ",\n" : "\n");
+        }
+        batch << ") AS v(employee_id, base_updated_at)\n"
+              << "WHERE e.employee_id = v.employee_id AND e.updated_at = v.base_updated_at";
+        if (strict) {
+            batch << "\nRETURNING 1\n)\n"
+                  << "SELECT sync_expect_rows(" << end - start << ", count(*), 'DELETE') FROM removed;\n";
+        } else {
+            batch << ";\n";
+        }
+    });
+}
+
+// ==================== TIMESTAMPS ====================
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+static long long daysFromCivil(long long y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(long long z, long long& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    d = static_cast<unsigned>(doy - (153 * mp + 2) / 5 + 1);
+    m = static_cast<unsigned>(mp < 10 ? mp + 3 : mp - 9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+static const long long MICROS_PER_SECOND = 1000000;
+static const long long MICROS_PER_DAY = 86400 * MICROS_PER_SECOND;
+
+// TIMESTAMP columns have no time zone, so local time is used both ways
+SyncTime SyncEngine::toSyncTime(time_t t) {
+    tm local;
+#ifdef _WIN32
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    long long days = daysFromCivil(local.tm_year + 1900LL, static_cast<unsigned>(local.tm_mon + 1),
+                                   static_cast<unsigned>(local.tm_mday));
+    return (days * 86400 + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec) * MICROS_PER_SECOND;
+}
+
+time_t SyncEngine::toTimeT(SyncTime t) {
+    long long days = t >= 0 ? t / MICROS_PER_DAY : -((-t + MICROS_PER_DAY - 1) / MICROS_PER_DAY);
+    long long seconds = (t - days * MICROS_PER_DAY) / MICROS_PER_SECOND;
+    long long year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    tm local = {};
+    local.tm_year = static_cast<int>(year - 1900);
+    local.tm_mon = static_cast<int>(month) - 1;
+    local.tm_mday = static_cast<int>(day);
+    local.tm_hour = static_cast<int>(seconds / 3600);
+    local.tm_min = static_cast<int>(seconds / 60 % 60);
+    local.tm_sec = static_cast<int>(seconds % 60);
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+string SyncEngine::formatTimestamp(SyncTime t) {
+    long long days = t >= 0 ? t / MICROS_PER_DAY : -((-t + MICROS_PER_DAY - 1) / MICROS_PER_DAY);
+    long long micros = t - days * MICROS_PER_DAY;
+    long long seconds = micros / MICROS_PER_SECOND;
+    long long year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u %02lld:%02lld:%02lld.%06lld",
+             year, month, day, seconds / 3600, seconds / 60 % 60, seconds % 60,
+             micros % MICROS_PER_SECOND);
+    return buffer;
+}
+
+// Accepts PostgreSQL's text output, with or without fractional seconds
+bool SyncEngine::parseTimestamp(const string& text, SyncTime& t) {
+    int year, month, day, hour, minute, second, consumed = 0;
+    if (sscanf(text.c_str(), "%d-%d-%d %d:%d:%d%n",
+               &year, &month, &day, &hour, &minute, &second, &consumed) != 6) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+
+    long long fraction = 0;
+    size_t pos = static_cast<size_t>(consumed);
+    if (pos < text.size() && text[pos] == '.') {
+        int digits = 0;
+        for (pos++; pos < text.size() && isdigit(static_cast<unsigned char>(text[pos])); pos++) {
+            if (digits < 6) {
+                fraction = fraction * 10 + (text[pos] - '0');
+                digits++;
+            }
+        }
+        for (; digits < 6; digits++) {
+            fraction *= 10;
+        }
+    }
+    if (pos != text.size()) {
+        return false;
+    }
+
+    long long days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    t = (days * 86400 + hour * 3600 + minute * 60 + second) * MICROS_PER_SECOND + fraction;
+    return true;
+}
+
+string SyncEngine::quoteLiteral(const string& value) {
+    string quoted = "'";
+    for (char ch : value) {
+        if (ch == '\'') {
+            quoted += '\'';
+        }
+        quoted += ch;
+    }
+    return quoted + "'";
+}
+
+string SyncEngine::escapeCopy(const string& value) {
+    string escaped;
+    for (char ch : value) {
+        switch(ch) {
+            case '\\': escaped += "\\\\"; break;
+            case '\t': escaped += "\\t"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            default: escaped += ch; break;
+        }
+    }
+    return escaped;
+}
+
+string SyncEngine::unescapeCopy(const string& value) {
+    string plain;
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            plain += value[i];
+            continue;
+        }
+        switch(value[++i]) {
+            case 't': plain += '\t'; break;
+            case 'n': plain += '\n'; break;
+            case 'r': plain += '\r'; break;
+            default: plain += value[i]; break;
+        }
+    }
+    return plain;
+}
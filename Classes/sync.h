@@ -0,0 +1,131 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "employee.h"
+#include "blob_store.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <iostream>
+#include <ctime>
+
+// Database timestamp in microseconds. TIMESTAMP columns carry no time
+// zone, so this counts local wall-clock time rather than UTC.
+typedef long long SyncTime;
+
+// Output format for the change set
+enum SyncFormat {
+    SYNC_SQL,  // batched multi-row INSERT/UPDATE/DELETE statements
+    SYNC_COPY  // COPY ... FROM STDIN for inserts, batched SQL for the rest
+};
+
+// Result of one sync run
+struct SyncReport {
+    size_t inserted;
+    size_t updated;
+    size_t deleted;
+    SyncTime stamp;                     // updated_at written to every row
+    std::vector<std::string> conflicts; // employee IDs changed remotely, not written
+
+    SyncReport() : inserted(0), updated(0), deleted(0), stamp(0) {}
+};
+
+// Emits only the rows that changed since the last sync, for the
+// employees table in DB/employee_management_schema.sql.
+//
+// Every written row gets updated_at set to the run's stamp, and once the
+// write is confirmed that stamp becomes the row's baseline. UPDATEs and
+// DELETEs only apply where the database still holds the baseline, and
+// the script checks each statement's row count with sync_expect_rows()
+// (see the schema): if someone else changed a row, the statement raises
+// and the whole transaction rolls back. With a remote snapshot loaded,
+// such rows are reported as conflicts up front and not written at all.
+//
+// Records stay dirty until the script is confirmed, either by
+// acknowledge() or by a later snapshot showing the written stamps.
+class SyncEngine {
+private:
+    struct PendingRow {
+        std::shared_ptr<Employee> emp;
+        unsigned long revision; // revision that was written
+    };
+
+    std::map<std::string, SyncTime> baseline;     // employee_id -> updated_at we know the row has
+    std::map<std::string, SyncTime> remoteState;  // latest snapshot from loadRemoteState()
+    std::set<std::string> pendingDeletes;
+
+    // Written by the last sync(), not confirmed yet
+    std::vector<PendingRow> unconfirmedRows;
+    std::vector<std::string> unconfirmedDeletes;
+    SyncTime unconfirmedStamp;
+
+    SyncTime lastStamp;
+    size_t lastConfirmed;
+    size_t batchSize;
+    BlobStore& pictures;
+
+    bool hasConflict(const std::string& id) const;
+    bool baseFor(const std::string& id, SyncTime& base) const;
+    SyncTime nextStamp();
+    void confirmRow(const PendingRow& row);
+
+    void writeInserts(const std::vector<std::shared_ptr<Employee>>& rows, SyncTime stamp,
+                      std::ostream& out, SyncFormat format) const;
+    void writeUpdates(unsigned fields, const std::vector<std::shared_ptr<Employee>>& rows,
+                      SyncTime stamp, std::ostream& out) const;
+    void writeDeletes(const std::vector<std::pair<std::string, SyncTime>>& rows, bool strict,
+                      std::ostream& out) const;
+
+public:
+    // Profile pictures are imported into and exported from the given store
+    explicit SyncEngine(BlobStore& pictures, size_t batchSize = 500);
+
+    // Remember a removed employee so the next sync deletes the row
+    void recordDelete(const Employee& emp);
+
+    // Replace the roster with rows exported from the database, one
+    // tab-separated line per employee as written by
+    //   COPY (SELECT employee_id, first_name, last_name, email, phone, gender,
+    //                department, employee_type, profile_picture, created_at,
+    //                updated_at
+    //         FROM employees) TO STDOUT;
+    // The loaded records start clean, with their updated_at as baseline.
+    // Inline (data URI) pictures are moved into the BlobStore and only the
+    // handle is kept; other values, such as URLs, are left in the database.
+    bool loadRoster(std::istream& in, std::vector<std::shared_ptr<Employee>>& employees);
+
+    // Read the remote updated_at values, one "employee_id<TAB>updated_at"
+    // row per line, e.g. the output of
+    //   COPY (SELECT employee_id, updated_at FROM employees) TO STDOUT;
+    // Rows of the last sync that show up with its stamp (or, for deletes,
+    // are gone) are confirmed; the rest stay dirty for the next run.
+    // This is also the file-based stand-in when no database is available.
+    bool loadRemoteState(std::istream& in);
+
+    // Write the change set to out. Any previous unconfirmed run is
+    // treated as not applied and its records are written again.
+    SyncReport sync(std::vector<std::shared_ptr<Employee>>& employees,
+                    std::ostream& out, SyncFormat format = SYNC_SQL);
+
+    // The last script committed: mark its records clean
+    void acknowledge();
+    // The last script failed: keep its records dirty
+    void discardUnconfirmed();
+
+    bool hasUnconfirmed() const;
+    size_t confirmedCount() const { return lastConfirmed; }
+    size_t pendingDeleteCount() const { return pendingDeletes.size(); }
+
+    // Helpers for the PostgreSQL text formats
+    static SyncTime toSyncTime(std::time_t t);
+    static std::time_t toTimeT(SyncTime t);
+    static std::string formatTimestamp(SyncTime t);
+    static bool parseTimestamp(const std::string& text, SyncTime& t);
+    static std::string quoteLiteral(const std::string& value);
+    static std::string escapeCopy(const std::string& value);
+    static std::string unescapeCopy(const std::string& value);
+};
+
+#endif // SYNC_H
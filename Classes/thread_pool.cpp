@@ -0,0 +1,128 @@
+#include "thread_pool.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+
+using namespace std;
+
+// Pool and index of the worker running on this thread, if any
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local long currentWorker = -1;
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : pending(0), nextQueue(0), stopping(false) {
+    for (size_t i = 0; i < threadCount; i++) {
+        queues.push_back(unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+// The calling thread takes part in every parallelFor(), so one worker
+// fewer than the core count keeps all cores busy
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(max(1u, thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+long ThreadPool::workerIndex() const {
+    return currentPool == this ? currentWorker : -1;
+}
+
+void ThreadPool::submit(function<void()> task) {
+    if (queues.empty()) {
+        task();
+        return;
+    }
+
+    // Workers keep their own subtasks local; others are spread round-robin
+    long worker = workerIndex();
+    size_t target = worker >= 0 ? static_cast<size_t>(worker)
+                                : nextQueue++ % queues.size();
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(move(task));
+        pending++;
+    }
+    {
+        // Taking the lock closes the gap between a worker's check and its wait
+        lock_guard<mutex> guard(sleepLock);
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popTask(size_t self, function<void()>& task) {
+    size_t count = queues.size();
+
+    // Own work first, newest task for cache locality
+    if (self < count) {
+        lock_guard<mutex> guard(queues[self]->lock);
+        auto& own = queues[self]->tasks;
+        if (!own.empty()) {
+            task = move(own.back());
+            own.pop_back();
+            pending--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task, which tends to be the largest
+    for (size_t k = 1; k <= count; k++) {
+        size_t victim = (self + k) % count;
+        if (victim == self) {
+            continue;
+        }
+        lock_guard<mutex> guard(queues[victim]->lock);
+        auto& other = queues[victim]->tasks;
+        if (!other.empty()) {
+            task = move(other.front());
+            other.pop_front();
+            pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    function<void()> task;
+    long worker = workerIndex();
+    size_t self = worker >= 0 ? static_cast<size_t>(worker) : queues.size();
+    if (pending == 0 || !popTask(self, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = static_cast<long>(index);
+    function<void()> task;
+
+    while (true) {
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [this]() { return stopping || pending > 0; });
+        if (stopping && pending == 0) {
+            return;
+        }
+    }
+}
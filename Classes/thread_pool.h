@@ -0,0 +1,196 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <exception>
+#include <cstddef>
+
+// Work-stealing thread pool for bulk roster operations. Every worker owns
+// a task deque: it takes its own work from the back and, when idle, steals
+// from the front of the others. Threads waiting on a parallelFor() help
+// run queued tasks, so nested parallel calls cannot deadlock the pool.
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex lock;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending;     // tasks queued but not yet taken
+    std::atomic<size_t> nextQueue;   // round-robin target for outside submits
+    std::atomic<bool> stopping;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+
+    bool popTask(size_t self, std::function<void()>& task);
+    void workerLoop(size_t index);
+    long workerIndex() const;  // this thread's worker index in this pool, or -1
+
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    // Tasks must not throw; parallelFor() wraps its own
+    void submit(std::function<void()> task);
+
+    // Run one queued task on the calling thread; false if none was found
+    bool runPendingTask();
+
+    // Call fn(lo, hi) over [begin, end) split into chunks of at least grain.
+    // If fn throws, the remaining chunks still finish and the first
+    // exception is rethrown to the caller.
+    template<typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t grain, Fn fn);
+
+    // Map each chunk with map(lo, hi) and fold the results left to right
+    template<typename T, typename Map, typename Combine>
+    T parallelReduce(size_t begin, size_t end, size_t grain, T init, Map map, Combine combine);
+
+    // Sort chunks in parallel, then merge them pairwise
+    template<typename RandomIt, typename Compare>
+    void parallelSort(RandomIt first, RandomIt last, Compare comp);
+
+    // Pool sized to the machine, shared by the whole program
+    static ThreadPool& shared();
+};
+
+// ==================== TEMPLATE IMPLEMENTATION ====================
+
+template<typename Fn>
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, Fn fn) {
+    if (end <= begin) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    size_t count = end - begin;
+    // A few chunks per thread leaves room for stealing to balance load
+    size_t chunks = std::min((count + grain - 1) / grain, (size() + 1) * 4);
+    if (chunks <= 1 || size() == 0) {
+        fn(begin, end);
+        return;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    std::atomic<size_t> remaining(chunks - 1);
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    // Queued tasks refer to this frame, so it must not unwind before they finish
+    auto runChunk = [&fn, &error, &errorLock](size_t lo, size_t hi) {
+        try {
+            if (lo < hi) {
+                fn(lo, hi);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    for (size_t c = 1; c < chunks; c++) {
+        size_t lo = begin + c * chunkSize;
+        size_t hi = std::min(end, lo + chunkSize);
+        submit([&runChunk, &remaining, lo, hi]() {
+            runChunk(lo, hi);
+            remaining--;
+        });
+    }
+
+    runChunk(begin, std::min(end, begin + chunkSize));
+
+    while (remaining > 0) {
+        if (!runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template<typename T, typename Map, typename Combine>
+T ThreadPool::parallelReduce(size_t begin, size_t end, size_t grain, T init,
+                             Map map, Combine combine) {
+    if (end <= begin) {
+        return init;
+    }
+    grain = std::max<size_t>(grain, 1);
+    size_t chunks = std::min((end - begin + grain - 1) / grain, (size() + 1) * 4);
+    size_t chunkSize = (end - begin + chunks - 1) / chunks;
+
+    // One slot per chunk keeps the fold order deterministic
+    std::vector<T> partials(chunks);
+    parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; c++) {
+            size_t from = begin + c * chunkSize;
+            size_t to = std::min(end, from + chunkSize);
+            if (from < to) {
+                partials[c] = map(from, to);
+            }
+        }
+    });
+
+    T result = init;
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+template<typename RandomIt, typename Compare>
+void ThreadPool::parallelSort(RandomIt first, RandomIt last, Compare comp) {
+    size_t count = static_cast<size_t>(last - first);
+    size_t chunks = std::min(size() + 1, count / 4096);
+    if (chunks <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t c = 0; c <= chunks; c++) {
+        bounds[c] = count * c / chunks;
+    }
+
+    parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; c++) {
+            std::sort(first + static_cast<std::ptrdiff_t>(bounds[c]),
+                      first + static_cast<std::ptrdiff_t>(bounds[c + 1]), comp);
+        }
+    });
+
+    // Merge neighbouring runs, doubling the run width each round
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        parallelFor(0, pairs, 1, [&](size_t lo, size_t hi) {
+            for (size_t p = lo; p < hi; p++) {
+                size_t left = p * 2 * width;
+                size_t mid = std::min(left + width, chunks);
+                size_t right = std::min(left + 2 * width, chunks);
+                if (mid < right) {
+                    std::inplace_merge(first + static_cast<std::ptrdiff_t>(bounds[left]),
+                                       first + static_cast<std::ptrdiff_t>(bounds[mid]),
+                                       first + static_cast<std::ptrdiff_t>(bounds[right]), comp);
+                }
+            }
+        });
+    }
+}
+
+#endif // THREAD_POOL_H
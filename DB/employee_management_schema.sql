@@ -44,7 +44,11 @@ CREATE INDEX idx_employee_name ON employees(last_name, first_name);
 CREATE OR REPLACE FUNCTION update_updated_at_column()
 RETURNS TRIGGER AS $$
 BEGIN
-    NEW.updated_at = CURRENT_TIMESTAMP;
+    -- Keep an updated_at set by the statement itself (the desktop app's
+    -- sync writes its own stamp and matches on it later)
+    IF NEW.updated_at IS NOT DISTINCT FROM OLD.updated_at THEN
+        NEW.updated_at = CURRENT_TIMESTAMP;
+    END IF;
     RETURN NEW;
 END;
 $$ language 'plpgsql';
@@ -54,6 +58,18 @@ CREATE TRIGGER update_employees_updated_at
     FOR EACH ROW 
     EXECUTE FUNCTION update_updated_at_column();
 
+-- Called by the desktop app's sync scripts after each guarded UPDATE or
+-- DELETE; raising aborts the script's transaction when a row was changed
+-- by someone else since the last sync
+CREATE OR REPLACE FUNCTION sync_expect_rows(expected BIGINT, affected BIGINT, statement TEXT)
+RETURNS VOID AS $$
+BEGIN
+    IF affected <> expected THEN
+        RAISE EXCEPTION 'sync conflict: % matched % of % rows', statement, affected, expected;
+    END IF;
+END;
+$$ language 'plpgsql';
+
 -- ============================================
 -- STEP 5: INSERT SAMPLE DATA
 -- (Matching your demo credentials and web app)
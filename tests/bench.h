@@ -0,0 +1,135 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Shared helpers for the bench_*.cpp programs: argument parsing, timing
+// and a deterministic synthetic roster. Sizes default to values that run
+// in seconds on a laptop; pass a larger count as the first argument to
+// reproduce the sizes named in the original requests.
+
+#include "employee.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// First argument as a record count, or fallback
+inline size_t benchSize(int argc, char** argv, size_t fallback) {
+    if (argc > 1) {
+        size_t value = std::strtoull(argv[1], nullptr, 10);
+        if (value > 0) {
+            return value;
+        }
+    }
+    return fallback;
+}
+
+// Milliseconds taken by fn, best of runs
+template<typename Fn>
+double bestMillis(int runs, Fn fn) {
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double millis = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        best = (run == 0 || millis < best) ? millis : best;
+    }
+    return best;
+}
+
+// Counts what display code writes, so the output cannot be optimised away
+class CountingBuffer : public std::streambuf {
+public:
+    size_t bytes = 0;
+protected:
+    int overflow(int c) override { bytes++; return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        bytes += static_cast<size_t>(n);
+        return n;
+    }
+};
+
+// ==================== SYNTHETIC ROSTER ====================
+
+static const char* const BENCH_FIRST_NAMES[] = {
+    "John", "Jane", "Bob", "Alice", "Carlos", "Mei", "Omar", "Priya",
+    "Sven", "Aiko", "Liam", "Zoe", "Ravi", "Nora", "Ivan", "Lena"
+};
+static const char* const BENCH_LAST_NAMES[] = {
+    "Doe", "Smith", "Johnson", "Garcia", "Chen", "Khan", "Patel", "Berg",
+    "Tanaka", "Murphy", "Rossi", "Novak", "Kim", "Silva", "Meyer", "Okafor"
+};
+static const char* const BENCH_DEPARTMENTS[] = {
+    "HR", "IT", "Finance", "Marketing", "Operations", "Sales", "Design", "Engineering"
+};
+static const char* const BENCH_TYPES[] = { "full-time", "part-time", "intern" };
+static const char* const BENCH_DOMAINS[] = {
+    "employee.com", "corp.example.com", "mail.example.org", "contractor.example.net"
+};
+
+// Cheap deterministic mixing so field combinations look random
+inline size_t benchMix(size_t i, size_t salt) {
+    unsigned long long x = (static_cast<unsigned long long>(i) + 1) * 0x9E3779B97F4A7C15ULL + salt;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 29;
+    return static_cast<size_t>(x);
+}
+
+// Field values of synthetic employee i
+struct BenchFields {
+    std::string first, last, email, phone, gender, department, type;
+};
+
+inline BenchFields benchFields(size_t i) {
+    BenchFields f;
+    f.first = BENCH_FIRST_NAMES[benchMix(i, 1) % 16];
+    f.last = BENCH_LAST_NAMES[benchMix(i, 2) % 16];
+    std::ostringstream email, phone;
+    email << f.first << "." << f.last << i << "@" << BENCH_DOMAINS[benchMix(i, 3) % 4];
+    size_t digits = benchMix(i, 4) % 10000000000ULL;
+    phone << "(" << std::setw(3) << std::setfill('0') << digits / 10000000 << ") "
+          << std::setw(3) << digits / 10000 % 1000 << "-" << std::setw(4) << digits % 10000;
+    f.email = email.str();
+    f.phone = phone.str();
+    f.gender = benchMix(i, 5) % 2 ? "Female" : "Male";
+    f.department = BENCH_DEPARTMENTS[benchMix(i, 6) % 8];
+    f.type = BENCH_TYPES[benchMix(i, 7) % 3];
+    return f;
+}
+
+// Mixed-type roster held the way the application holds it
+inline std::vector<std::shared_ptr<Employee>> syntheticRoster(size_t count) {
+    Employee::resetCounter();
+    std::vector<std::shared_ptr<Employee>> employees;
+    employees.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        BenchFields f = benchFields(i);
+        employees.push_back(std::make_shared<Employee>(f.first, f.last, f.email, f.phone,
+                                                       f.gender, f.department, f.type));
+    }
+    return employees;
+}
+
+// The same roster as the database would export it for
+// SyncEngine::loadRoster(); picture(i) gives the profile_picture field,
+// already in COPY text form (\N for NULL)
+template<typename Picture>
+std::string rosterExport(size_t count, const std::string& timestamp, Picture picture) {
+    std::ostringstream out;
+    for (size_t i = 0; i < count; i++) {
+        BenchFields f = benchFields(i);
+        out << "EMP" << std::setw(7) << std::setfill('0') << i + 1 << std::setfill(' ') << "\t"
+            << f.first << "\t" << f.last << "\t" << f.email << "\t" << f.phone << "\t"
+            << f.gender << "\t" << f.department << "\t" << f.type << "\t"
+            << picture(i) << "\t" << timestamp << "\t" << timestamp << "\n";
+    }
+    return out.str();
+}
+
+#endif // BENCH_H
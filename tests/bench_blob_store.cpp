@@ -0,0 +1,111 @@
+// Roster load time and memory with and without inline profile pictures.
+//   build/bench_blob_store [records]
+// Default: 20,000 records (the request named 100k; pass 100000, which
+// writes about 300 MB of blobs). Half the employees use one of 8 shared
+// default avatars, the other half an own 6 KB picture.
+#include "bench.h"
+#include "sync.h"
+#include "compact_roster.h"
+#include <filesystem>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const size_t PICTURE_BYTES = 6 * 1024;
+
+// Picture bytes: a PNG signature and deterministic noise
+static string pictureBytes(size_t seed) {
+    string bytes("\x89PNG\r\n\x1a\n", 8);
+    bytes.reserve(PICTURE_BYTES);
+    for (size_t i = 0; bytes.size() < PICTURE_BYTES; i++) {
+        bytes += static_cast<char>(benchMix(i, seed) & 0xFF);
+    }
+    return bytes;
+}
+
+static size_t directoryBytes(const string& root) {
+    size_t bytes = 0;
+    for (const auto& entry : fs::directory_iterator(root)) {
+        bytes += static_cast<size_t>(entry.file_size());
+    }
+    return bytes;
+}
+
+struct LoadResult {
+    double millis;
+    size_t rosterBytes;
+    size_t blobBytes;
+};
+
+static LoadResult load(const string& exported, const string& root) {
+    fs::remove_all(root);
+    BlobStore pictures(root);
+    SyncEngine engine(pictures);
+    vector<shared_ptr<Employee>> employees;
+
+    LoadResult result;
+    result.millis = bestMillis(1, [&] {
+        istringstream in(exported);
+        if (!engine.loadRoster(in, employees)) {
+            cerr << "roster did not load\n";
+            exit(1);
+        }
+    });
+    result.rosterBytes = CompactRoster::estimateRosterBytes(employees);
+    result.blobBytes = directoryBytes(root);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 20000);
+    string when = SyncEngine::formatTimestamp(SyncEngine::toSyncTime(time(nullptr)));
+
+    // Data URIs as the web form stores them, made with a scratch store
+    string scratchRoot = "build/bench_blob_source";
+    fs::remove_all(scratchRoot);
+    BlobStore scratch(scratchRoot);
+    vector<string> avatars;
+    for (size_t a = 0; a < 8; a++) {
+        avatars.push_back(scratch.dataUriFor(scratch.put(pictureBytes(1000 + a))));
+    }
+    size_t inlineBytes = 0;
+    string withImages = rosterExport(count, when, [&](size_t i) {
+        string uri = i % 2 ? avatars[i / 2 % 8] : scratch.dataUriFor(scratch.put(pictureBytes(i)));
+        inlineBytes += uri.size();
+        return uri;
+    });
+    fs::remove_all(scratchRoot);
+    string withoutImages = rosterExport(count, when, [](size_t) { return string("\\N"); });
+
+    LoadResult plain = load(withoutImages, "build/bench_blobs_plain");
+    LoadResult pictured = load(withImages, "build/bench_blobs_inline");
+
+    // Before the blob store, the whole data URI stayed in each Employee
+    size_t inlineRoster = plain.rosterBytes + inlineBytes;
+
+    cout << "Records: " << count << "\n\n";
+    cout << left << setw(26) << "Roster" << setw(12) << "Export MB" << setw(12) << "Load ms"
+         << setw(14) << "Memory MB" << setw(12) << "Bytes/emp" << "Blob MB\n";
+    cout << string(86, '-') << "\n";
+    cout << fixed << setprecision(1);
+    auto row = [&](const char* name, size_t exportBytes, double millis, size_t memory, size_t blobs) {
+        cout << left << setw(26) << name << setw(12) << static_cast<double>(exportBytes) / 1e6
+             << setw(12) << millis << setw(14) << static_cast<double>(memory) / 1e6
+             << setw(12) << memory / count << static_cast<double>(blobs) / 1e6 << "\n";
+    };
+    row("No pictures", withoutImages.size(), plain.millis, plain.rosterBytes, plain.blobBytes);
+    row("Inline, handles kept", withImages.size(), pictured.millis, pictured.rosterBytes, pictured.blobBytes);
+    cout << left << setw(26) << "Inline, URIs in memory" << setw(12) << ""
+         << setw(12) << "" << setw(14) << static_cast<double>(inlineRoster) / 1e6
+         << setw(12) << inlineRoster / count << "(estimate)\n";
+
+    // Lazy retrieval: first access maps the file, later ones hit the cache
+    BlobStore pictures("build/bench_blobs_inline");
+    string handle = BlobStore::hashOf(pictureBytes(0));
+    size_t seen = 0;
+    double cold = bestMillis(1, [&] { seen += pictures.get(handle)->size(); });
+    double warm = bestMillis(5, [&] { seen += pictures.get(handle)->size(); });
+    cout << "\nPicture fetch: first " << cold * 1000 << " us, cached " << warm * 1000
+         << " us (" << seen << " bytes read)\n";
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Bytes per employee and lookup cost of the compact layout.
+//   build/bench_compact_roster [records]
+// Default: 500,000 records (the request named 10M; pass 10000000 on a
+// machine with about 8 GB free).
+#include "bench.h"
+#include "compact_roster.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 500000);
+    vector<shared_ptr<Employee>> employees = syntheticRoster(count);
+
+    CompactRoster compact;
+    double buildMillis = bestMillis(1, [&] { compact.build(employees); });
+    size_t regularBytes = CompactRoster::estimateRosterBytes(employees);
+    size_t compactBytes = compact.bytesUsed();
+
+    cout << "Records: " << count << ", compact build: " << fixed << setprecision(1)
+         << buildMillis << " ms\n\n";
+    cout << left << setw(12) << "Layout" << setw(14) << "Total MB" << "Bytes/employee\n";
+    cout << string(40, '-') << "\n";
+    cout << left << setw(12) << "Regular" << setw(14) << static_cast<double>(regularBytes) / 1e6
+         << regularBytes / count << "\n";
+    cout << left << setw(12) << "Compact" << setw(14) << static_cast<double>(compactBytes) / 1e6
+         << compactBytes / count << "\n\n";
+
+    const Employee& probe = *employees[count / 2];
+    string fname = probe.getFirstName(), lname = probe.getLastName();
+    string dept = probe.getDepartment(), type = probe.getEmployeeType();
+    size_t regularResult = 0, compactResult = 0;
+
+    cout << left << setw(20) << "Operation" << setw(14) << "Regular ms"
+         << setw(14) << "Compact ms" << "Result\n";
+    cout << string(60, '-') << "\n";
+    auto row = [&](const char* name, double regular, double compactMillis) {
+        cout << left << setw(20) << name << setw(14) << regular << setw(14) << compactMillis
+             << regularResult;
+        if (compactResult != regularResult) {
+            cout << " vs " << compactResult;
+        }
+        cout << "\n";
+    };
+
+    double regular = bestMillis(3, [&] {
+        regularResult = 0;
+        for (const auto& emp : employees) {
+            regularResult += emp->getFirstName() == fname && emp->getLastName() == lname;
+        }
+    });
+    double packed = bestMillis(3, [&] { compactResult = compact.findByName(fname, lname).size(); });
+    row("Find by name", regular, packed);
+
+    regular = bestMillis(3, [&] {
+        regularResult = 0;
+        for (const auto& emp : employees) {
+            regularResult += emp->getDepartment() == dept;
+        }
+    });
+    packed = bestMillis(3, [&] { compactResult = compact.filterByDepartment(dept).size(); });
+    row("Filter department", regular, packed);
+
+    regular = bestMillis(3, [&] {
+        regularResult = 0;
+        for (const auto& emp : employees) {
+            regularResult += emp->getEmployeeType() == type;
+        }
+    });
+    packed = bestMillis(3, [&] { compactResult = compact.filterByType(type).size(); });
+    row("Filter type", regular, packed);
+
+    // Display-time decoding of every record
+    regular = bestMillis(3, [&] {
+        regularResult = 0;
+        for (const auto& emp : employees) {
+            regularResult += emp->getEmail().size() + emp->getPhone().size() + emp->getFullName().size();
+        }
+    });
+    packed = bestMillis(3, [&] {
+        compactResult = 0;
+        for (size_t i = 0; i < compact.size(); i++) {
+            compactResult += compact.getEmail(i).size() + compact.getPhone(i).size() +
+                             compact.getFullName(i).size();
+        }
+    });
+    row("Decode all fields", regular, packed);
+    return 0;
+}
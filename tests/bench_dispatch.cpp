@@ -0,0 +1,144 @@
+// Iteration, sort and display over mixed-type records: the virtual
+// hierarchy the employee classes used to have, against the type tag and
+// the by-value TypedEmployee variant.
+//   build/bench_dispatch [records]
+// Default: 200,000 records (the request named 1M; pass 1000000).
+#include "bench.h"
+#include <algorithm>
+
+using namespace std;
+
+// ==================== VIRTUAL HIERARCHY (as before the change) ====================
+
+class VirtualEmployee {
+protected:
+    string employeeId, firstName, lastName, email, phone, gender, department, employeeType;
+
+    void print(const char* label) const {
+        cout << "\n===== " << label << " =====\n";
+        cout << "Employee ID:    " << employeeId << endl;
+        cout << "Name:           " << firstName + " " + lastName << endl;
+        cout << "Email:          " << email << endl;
+        cout << "Phone:          " << phone << endl;
+        cout << "Gender:         " << gender << endl;
+        cout << "Department:     " << department << endl;
+        cout << "Employee Type:  " << employeeType << endl;
+        cout << string(string(label).size() + 13, '=') << "\n";
+    }
+
+public:
+    VirtualEmployee(const Employee& e)
+        : employeeId(e.getEmployeeId()), firstName(e.getFirstName()), lastName(e.getLastName()),
+          email(e.getEmail()), phone(e.getPhone()), gender(e.getGender()),
+          department(e.getDepartment()), employeeType(e.getEmployeeType()) {
+    }
+    virtual ~VirtualEmployee() {}
+    virtual void displayDetails() const = 0;
+    virtual string getSortingKey() const { return employeeId; }
+};
+
+class VirtualFullTime : public VirtualEmployee {
+public:
+    using VirtualEmployee::VirtualEmployee;
+    void displayDetails() const override { print("FULL-TIME EMPLOYEE"); }
+    string getSortingKey() const override { return "FT_" + employeeId; }
+};
+
+class VirtualPartTime : public VirtualEmployee {
+public:
+    using VirtualEmployee::VirtualEmployee;
+    void displayDetails() const override { print("PART-TIME EMPLOYEE"); }
+    string getSortingKey() const override { return "PT_" + employeeId; }
+};
+
+class VirtualIntern : public VirtualEmployee {
+public:
+    using VirtualEmployee::VirtualEmployee;
+    void displayDetails() const override { print("INTERN EMPLOYEE"); }
+    string getSortingKey() const override { return "IN_" + employeeId; }
+};
+
+static unique_ptr<VirtualEmployee> makeVirtual(const Employee& e) {
+    switch(e.getKind()) {
+        case KIND_FULL_TIME: return unique_ptr<VirtualEmployee>(new VirtualFullTime(e));
+        case KIND_PART_TIME: return unique_ptr<VirtualEmployee>(new VirtualPartTime(e));
+        default:             return unique_ptr<VirtualEmployee>(new VirtualIntern(e));
+    }
+}
+
+// ==================== BENCHMARK ====================
+
+// Times iterate (sum of sort-key lengths), sort by key and display of
+// every record, given how one layout reaches a record
+template<typename Container, typename Key, typename Display>
+static void run(const char* name, Container records, Key key, Display display) {
+    size_t keyChars = 0;
+    double iterate = bestMillis(3, [&] {
+        keyChars = 0;
+        for (const auto& r : records) {
+            keyChars += key(r).size();
+        }
+    });
+
+    // Every repetition sorts the roster order again; keys group by type
+    Container sorted;
+    double sort = bestMillis(3, [&] {
+        sorted = records;
+        std::sort(sorted.begin(), sorted.end(), [&](const auto& a, const auto& b) {
+            return key(a) < key(b);
+        });
+    });
+
+    CountingBuffer counter;
+    streambuf* old = cout.rdbuf(&counter);
+    double shown = bestMillis(3, [&] {
+        for (const auto& r : records) {
+            display(r);
+        }
+    });
+    cout.rdbuf(old);
+
+    cout << left << setw(24) << name << setw(12) << iterate << setw(12) << sort
+         << setw(12) << shown << keyChars << " / " << key(sorted.front()) << " / "
+         << counter.bytes << "\n";
+}
+
+// Copies of unique_ptrs are not possible, so the virtual layout shares them
+typedef vector<shared_ptr<VirtualEmployee>> VirtualList;
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 200000);
+    vector<shared_ptr<Employee>> roster = syntheticRoster(count);
+
+    VirtualList virtuals;
+    vector<Employee> byValue;
+    vector<TypedEmployee> typed;
+    virtuals.reserve(count);
+    byValue.reserve(count);
+    typed.reserve(count);
+    for (const auto& emp : roster) {
+        virtuals.push_back(makeVirtual(*emp));
+        byValue.push_back(*emp);
+        appendTyped(*emp, typed);
+    }
+
+    cout << "Records: " << count << " (mixed full-time, part-time, intern)\n\n";
+    cout << left << setw(24) << "Layout" << setw(12) << "Iterate ms" << setw(12) << "Sort ms"
+         << setw(12) << "Display ms" << "Key chars / first key / bytes shown\n";
+    cout << string(100, '-') << "\n";
+    cout << fixed << setprecision(1);
+
+    run("Virtual, heap", virtuals,
+        [](const shared_ptr<VirtualEmployee>& e) { return e->getSortingKey(); },
+        [](const shared_ptr<VirtualEmployee>& e) { e->displayDetails(); });
+    run("Tag, shared_ptr", roster,
+        [](const shared_ptr<Employee>& e) { return e->getSortingKey(); },
+        [](const shared_ptr<Employee>& e) { e->displayDetails(); });
+    run("Tag, by value", byValue,
+        [](const Employee& e) { return e.getSortingKey(); },
+        [](const Employee& e) { e.displayDetails(); });
+    run("Variant, by value", typed,
+        [](const TypedEmployee& e) { return getSortingKey(e); },
+        [](const TypedEmployee& e) { displayDetails(e); });
+    return 0;
+}
@@ -0,0 +1,88 @@
+// A dashboard's query mix replayed with and without the result cache.
+//   build/bench_query_cache [records] [requests]
+// Defaults: 100,000 records and 500 requests. Every 50th request is
+// an edit that moves one employee to another department, as the update
+// menu does, so the cache has to invalidate as well as hit.
+#include "bench.h"
+#include "query_cache.h"
+
+using namespace std;
+
+// Panels of a dashboard that refreshes a few times a minute
+static vector<Query> dashboardQueries() {
+    vector<Query> queries;
+    for (const char* dept : { "HR", "IT", "Finance", "Engineering", "Sales" }) {
+        queries.push_back(Query(QUERY_DEPARTMENT, MATCH_EXACT, dept, SORT_NAME, 0, 25));
+    }
+    for (const char* type : BENCH_TYPES) {
+        queries.push_back(Query(QUERY_TYPE, MATCH_EXACT, type, SORT_ID, 0, 50));
+    }
+    queries.push_back(Query(QUERY_NAME, MATCH_CONTAINS, "Chen", SORT_DEPARTMENT, 0, 20));
+    queries.push_back(Query(QUERY_NAME, MATCH_CONTAINS, "Priya", SORT_NONE, 0, 20));
+    queries.push_back(Query(QUERY_DEPARTMENT, MATCH_EXACT, "Design", SORT_NAME, 25, 25));
+    queries.push_back(Query(QUERY_EMPLOYEE_ID, MATCH_EXACT, "EMP1000"));
+    return queries;
+}
+
+struct ReplayResult {
+    double millis;
+    size_t rows;
+    QueryCacheStats stats;
+};
+
+static ReplayResult replay(vector<shared_ptr<Employee>>& employees, const EmployeeIndex& index,
+                           size_t requests, size_t memoryLimit) {
+    vector<Query> queries = dashboardQueries();
+    QueryCache cache(memoryLimit);
+    ReplayResult result;
+    result.rows = 0;
+    result.millis = bestMillis(1, [&] {
+        for (size_t r = 0; r < requests; r++) {
+            if (r % 50 == 49) {
+                auto& emp = employees[benchMix(r, 9) % employees.size()];
+                string oldDept = emp->getDepartment();
+                emp->setDepartment(BENCH_DEPARTMENTS[benchMix(r, 10) % 8]);
+                cache.onUpdate(*emp, FIELD_DEPARTMENT, oldDept);
+                continue;
+            }
+            result.rows += runQuery(queries[r % queries.size()], employees, index, cache).size();
+        }
+    });
+    result.stats = cache.stats();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 100000);
+    size_t requests = argc > 2 ? strtoull(argv[2], nullptr, 10) : 500;
+
+    // Each replay starts from the same roster, since edits change it
+    vector<shared_ptr<Employee>> employees = syntheticRoster(count);
+    EmployeeIndex index;
+    for (const auto& emp : employees) {
+        index[emp->getEmployeeId()] = emp;
+    }
+    ReplayResult uncached = replay(employees, index, requests, 0);
+
+    employees = syntheticRoster(count);
+    index.clear();
+    for (const auto& emp : employees) {
+        index[emp->getEmployeeId()] = emp;
+    }
+    ReplayResult cached = replay(employees, index, requests, 4 * 1024 * 1024);
+
+    cout << "Records: " << count << ", requests: " << requests << "\n\n";
+    cout << left << setw(14) << "Cache" << setw(12) << "Total ms" << setw(14) << "ms/request"
+         << setw(8) << "Hits" << setw(8) << "Misses" << setw(15) << "Invalidations" << "Rows\n";
+    cout << string(80, '-') << "\n";
+    cout << fixed << setprecision(2);
+    auto row = [&](const char* name, const ReplayResult& r) {
+        cout << left << setw(14) << name << setw(12) << r.millis
+             << setw(14) << r.millis / static_cast<double>(requests)
+             << setw(8) << r.stats.hits << setw(8) << r.stats.misses
+             << setw(15) << r.stats.invalidations << r.rows << "\n";
+    };
+    row("Off", uncached);
+    row("4 MB LRU", cached);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Sync time for 1% churn against a full export of the same roster.
+//   build/bench_sync [records]
+// Default: 200,000 records (the request named 1M; pass 1000000).
+#include "bench.h"
+#include "sync.h"
+#include <filesystem>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 200000);
+    string root = "build/bench_sync_blobs";
+    filesystem::remove_all(root);
+    BlobStore pictures(root);
+
+    SyncTime stamp = SyncEngine::toSyncTime(time(nullptr)) - 3600LL * 1000000;
+    string exported = rosterExport(count, SyncEngine::formatTimestamp(stamp),
+                                   [](size_t) { return string("\\N"); });
+
+    SyncEngine engine(pictures);
+    vector<shared_ptr<Employee>> employees;
+    double loadMillis = bestMillis(1, [&] {
+        istringstream in(exported);
+        if (!engine.loadRoster(in, employees)) {
+            cerr << "roster did not load\n";
+            exit(1);
+        }
+    });
+
+    // 1% churn: every hundredth employee gets a new email
+    size_t changed = 0;
+    for (size_t i = 0; i < employees.size(); i += 100) {
+        employees[i]->setEmail("moved" + to_string(i) + "@employee.com");
+        changed++;
+    }
+
+    // An unconfirmed run is written again by the next sync(), so every
+    // repetition does the same work
+    SyncReport report;
+    size_t sqlBytes = 0, copyBytes = 0;
+    double sqlMillis = bestMillis(3, [&] {
+        ostringstream out;
+        report = engine.sync(employees, out, SYNC_SQL);
+        sqlBytes = out.str().size();
+    });
+    double copyMillis = bestMillis(3, [&] {
+        ostringstream out;
+        engine.sync(employees, out, SYNC_COPY);
+        copyBytes = out.str().size();
+    });
+
+    // For comparison: every row written, as a full reload would
+    SyncEngine fresh(pictures);
+    vector<shared_ptr<Employee>> unsynced = syntheticRoster(count);
+    size_t fullBytes = 0;
+    double fullMillis = bestMillis(3, [&] {
+        ostringstream out;
+        fresh.sync(unsynced, out, SYNC_COPY);
+        fullBytes = out.str().size();
+    });
+
+    cout << "Records: " << count << ", changed: " << changed
+         << " (rows updated: " << report.updated << ")\n";
+    cout << "Roster load: " << fixed << setprecision(1) << loadMillis << " ms\n\n";
+    cout << left << setw(24) << "Run" << setw(12) << "ms" << "Script bytes\n";
+    cout << string(50, '-') << "\n";
+    cout << left << setw(24) << "1% churn, SQL" << setw(12) << sqlMillis << sqlBytes << "\n";
+    cout << left << setw(24) << "1% churn, COPY" << setw(12) << copyMillis << copyBytes << "\n";
+    cout << left << setw(24) << "All rows, COPY" << setw(12) << fullMillis << fullBytes << "\n";
+    return 0;
+}
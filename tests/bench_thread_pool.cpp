@@ -0,0 +1,130 @@
+// Scaling of the parallel bulk operations from 1 to N threads.
+//   build/bench_thread_pool [records] [max threads]
+// Defaults: 500,000 records, up to the machine's core count. Each step
+// uses a pool of threads - 1 workers, since the calling thread takes part
+// the same way it does with ThreadPool::shared().
+#include "bench.h"
+#include "thread_pool.h"
+#include "query_cache.h"
+#include <algorithm>
+#include <map>
+#include <thread>
+
+using namespace std;
+
+typedef vector<shared_ptr<Employee>> EmployeeList;
+
+// The filter scan behind runQuery()
+static size_t filterScan(ThreadPool& pool, const EmployeeList& employees) {
+    EmployeeList found = pool.parallelReduce(0, employees.size(), SCAN_GRAIN, EmployeeList(),
+        [&](size_t lo, size_t hi) {
+            EmployeeList chunk;
+            for (size_t i = lo; i < hi; i++) {
+                if (employees[i]->getDepartment() == "Engineering" &&
+                    employees[i]->getFullName().find("an") != string::npos) {
+                    chunk.push_back(employees[i]);
+                }
+            }
+            return chunk;
+        },
+        [](EmployeeList result, EmployeeList chunk) {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+            return result;
+        });
+    return found.size();
+}
+
+// The sort menu's name order, on a copy of the roster
+static size_t sortByName(ThreadPool& pool, const EmployeeList& employees) {
+    EmployeeList copy = employees;
+    pool.parallelSort(copy.begin(), copy.end(), compareByName);
+    return copy.size();
+}
+
+// Head count per department and type, as a statistics view would recompute it
+static size_t aggregate(ThreadPool& pool, const EmployeeList& employees) {
+    typedef map<string, size_t> Counts;
+    Counts counts = pool.parallelReduce(0, employees.size(), SCAN_GRAIN, Counts(),
+        [&](size_t lo, size_t hi) {
+            Counts chunk;
+            for (size_t i = lo; i < hi; i++) {
+                chunk[employees[i]->getDepartment() + "/" + employees[i]->getEmployeeType()]++;
+            }
+            return chunk;
+        },
+        [](Counts result, const Counts& chunk) {
+            for (const auto& entry : chunk) {
+                result[entry.first] += entry.second;
+            }
+            return result;
+        });
+    return counts.size();
+}
+
+// Table rows as rendered by the display and filter menus
+static size_t renderRows(ThreadPool& pool, const EmployeeList& employees) {
+    string rows = pool.parallelReduce(0, employees.size(), SCAN_GRAIN, string(),
+        [&](size_t lo, size_t hi) {
+            ostringstream out;
+            for (size_t i = lo; i < hi; i++) {
+                const auto& emp = employees[i];
+                out << left << setw(10) << emp->getEmployeeId()
+                    << setw(20) << emp->getFullName()
+                    << setw(15) << emp->getEmployeeType()
+                    << setw(15) << emp->getDepartment()
+                    << setw(20) << emp->getEmail() << "\n";
+            }
+            return out.str();
+        },
+        [](string result, const string& chunk) {
+            result += chunk;
+            return result;
+        });
+    return rows.size();
+}
+
+int main(int argc, char** argv) {
+    size_t count = benchSize(argc, argv, 500000);
+    size_t maxThreads = max(1u, thread::hardware_concurrency());
+    if (argc > 2) {
+        maxThreads = max<size_t>(1, strtoull(argv[2], nullptr, 10));
+    }
+
+    EmployeeList employees = syntheticRoster(count);
+    cout << "Records: " << count << ", cores: " << thread::hardware_concurrency() << "\n\n";
+
+    struct Operation {
+        const char* name;
+        size_t (*run)(ThreadPool&, const EmployeeList&);
+    };
+    const Operation operations[] = {
+        { "Filter scan", filterScan },
+        { "Sort by name", sortByName },
+        { "Aggregate", aggregate },
+        { "Render rows", renderRows },
+    };
+
+    // 1, 2, 4, ... and always maxThreads itself
+    vector<size_t> steps;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        steps.push_back(threads);
+    }
+    steps.push_back(maxThreads);
+
+    cout << left << setw(16) << "Operation" << setw(10) << "Threads"
+         << setw(12) << "ms" << setw(10) << "Speedup" << "Result\n";
+    cout << string(60, '-') << "\n";
+    cout << fixed << setprecision(1);
+    for (const auto& op : operations) {
+        double serial = 0;
+        for (size_t threads : steps) {
+            ThreadPool pool(threads - 1);
+            size_t result = 0;
+            double millis = bestMillis(3, [&] { result = op.run(pool, employees); });
+            serial = threads == 1 ? millis : serial;
+            cout << left << setw(16) << op.name << setw(10) << threads
+                 << setw(12) << millis << setw(10) << serial / millis << result << "\n";
+        }
+    }
+    return 0;
+}
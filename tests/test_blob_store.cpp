@@ -0,0 +1,181 @@
+// Deduplication, collisions, eviction and the inline picture format
+#include "check.h"
+#include "blob_store.h"
+#include "thread_pool.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const string ROOT = "build/test_blob_store_data";
+
+static string freshRoot(const string& name) {
+    string root = ROOT + "/" + name;
+    fs::remove_all(root);
+    return root;
+}
+
+static size_t blobFiles(const string& root) {
+    size_t count = 0;
+    for (const auto& entry : fs::directory_iterator(root)) {
+        count += entry.path().extension() == ".blob";
+    }
+    return count;
+}
+
+static void testDeduplication() {
+    string root = freshRoot("dedup");
+    BlobStore store(root);
+
+    string a = store.put("same bytes");
+    string b = store.put("same bytes");
+    string c = store.put("other bytes");
+    CHECK_EQ(a, b);
+    CHECK(a != c);
+    CHECK_EQ(a, BlobStore::hashOf("same bytes"));
+    CHECK_EQ(blobFiles(root), size_t(2));
+
+    // A second store over the same directory finds the existing blob
+    BlobStore reopened(root);
+    CHECK_EQ(reopened.put("same bytes"), a);
+    CHECK_EQ(blobFiles(root), size_t(2));
+}
+
+static void testCollision() {
+    string root = freshRoot("collision");
+    BlobStore store(root);
+
+    // Occupy the content's hash with different bytes, as a colliding blob would
+    string data = "real picture";
+    string hash = BlobStore::hashOf(data);
+    {
+        ofstream squatter(root + "/" + hash + ".blob", ios::binary);
+        squatter << "something else";
+    }
+
+    string handle = store.put(data);
+    CHECK_EQ(handle, hash + "-1");
+    CHECK_EQ(store.put(data), hash + "-1");
+
+    auto blob = store.get(handle);
+    CHECK(blob && string(blob->data(), blob->size()) == data);
+    auto other = store.get(hash);
+    CHECK(other && string(other->data(), other->size()) == "something else");
+}
+
+static void testEmptyBlob() {
+    BlobStore store(freshRoot("empty"));
+
+    string handle = store.put("");
+    CHECK(!handle.empty());
+    CHECK(store.contains(handle));
+    auto blob = store.get(handle);
+    CHECK(blob && blob->size() == 0);
+
+    ostringstream out;
+    CHECK(store.writeTo(handle, out));
+    CHECK(out.str().empty());
+    CHECK_EQ(store.dataUriFor(handle), string("data:application/octet-stream;base64,"));
+}
+
+static void testEviction() {
+    BlobStore store(freshRoot("lru"), 100);
+
+    string a = store.put(string(40, 'a'));
+    string b = store.put(string(40, 'b'));
+    string c = store.put(string(40, 'c'));
+    string huge = store.put(string(500, 'h'));
+
+    store.get(a);
+    store.get(b);
+    CHECK_EQ(store.cachedBytes(), size_t(80));
+    store.get(a);          // a is now the most recently used
+    store.get(c);          // over the limit: b goes
+    CHECK_EQ(store.cachedBytes(), size_t(80));
+
+    // Larger than the whole cache: returned but not cached
+    auto big = store.get(huge);
+    CHECK(big && big->size() == 500);
+    CHECK_EQ(store.cachedBytes(), size_t(80));
+
+    // Evicted blobs load again from disk
+    auto again = store.get(b);
+    CHECK(again && string(again->data(), again->size()) == string(40, 'b'));
+    CHECK(store.cachedBytes() <= 100);
+
+    CHECK(!store.get("0000000000000000"));
+    CHECK(!store.get(""));
+}
+
+static void testWriteTo() {
+    BlobStore store(freshRoot("write"));
+
+    string bytes;
+    for (int i = 0; i < 70000; i++) {
+        bytes += static_cast<char>(i * 31);
+    }
+    string handle = store.put(bytes);
+
+    ostringstream out;
+    CHECK(store.writeTo(handle, out));
+    CHECK(out.str() == bytes);
+
+    ostringstream missing;
+    CHECK(!store.writeTo("ffffffffffffffff", missing));
+}
+
+static void testDataUris() {
+    BlobStore store(freshRoot("uri"));
+
+    // Every padding length, and the MIME type comes from the content
+    const string samples[] = { string("\x89PNG\r\n\x1a\n", 8), "GIF89a!", string("\xFF\xD8\xFF\xE0", 4), "x" };
+    for (const auto& sample : samples) {
+        string handle = store.put(sample);
+        string uri = store.dataUriFor(handle);
+        CHECK_EQ(store.putDataUri(uri), handle);
+    }
+    CHECK_EQ(store.dataUriFor(store.put("GIF89a")), string("data:image/gif;base64,R0lGODlh"));
+    CHECK_EQ(store.putDataUri("data:image/png;base64,iVBORw0KGgo="),
+             BlobStore::hashOf(string("\x89PNG\r\n\x1a\n", 8)));
+
+    CHECK_EQ(store.putDataUri("https://example.com/a.png"), string(""));
+    CHECK_EQ(store.putDataUri("data:image/png,plain"), string(""));
+    CHECK_EQ(store.putDataUri("data:image/png;base64,ab$d"), string(""));
+    CHECK_EQ(store.dataUriFor("0000000000000000"), string(""));
+}
+
+static void testConcurrentReads() {
+    BlobStore store(freshRoot("threads"), 64);
+    vector<string> handles;
+    for (int i = 0; i < 16; i++) {
+        handles.push_back(store.put(string(static_cast<size_t>(10 + i), static_cast<char>('a' + i))));
+    }
+
+    ThreadPool pool(4);
+    size_t bad = pool.parallelReduce(0, 4000, 10, size_t(0),
+        [&](size_t lo, size_t hi) {
+            size_t failures = 0;
+            for (size_t i = lo; i < hi; i++) {
+                auto blob = store.get(handles[i % handles.size()]);
+                failures += !blob || blob->size() != 10 + i % handles.size();
+            }
+            return failures;
+        },
+        [](size_t a, size_t b) { return a + b; });
+    CHECK_EQ(bad, size_t(0));
+    CHECK(store.cachedBytes() <= 64);
+}
+
+int main() {
+    testDeduplication();
+    testCollision();
+    testEmptyBlob();
+    testEviction();
+    testWriteTo();
+    testDataUris();
+    testConcurrentReads();
+    return checkResult();
+}
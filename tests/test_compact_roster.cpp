@@ -0,0 +1,62 @@
+// Compact roster round trip, including values that overflow an intern table
+#include "check.h"
+#include "compact_roster.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+static shared_ptr<Employee> makeEmployee(const string& dept, const string& phone) {
+    return make_shared<Employee>("Ann", "Lee", "ann@employee.com", phone, "Female", dept, "intern");
+}
+
+static void testRoundTrip() {
+    Employee::resetCounter();
+    vector<shared_ptr<Employee>> employees;
+    employees.push_back(makeEmployee("IT", "(123) 456-7890"));
+    employees.push_back(makeEmployee("HR", "555-0100"));
+    employees.back()->setEmployeeId("CONTRACTOR-7");
+
+    CompactRoster compact;
+    compact.build(employees);
+    CHECK_EQ(compact.size(), size_t(2));
+    for (size_t i = 0; i < employees.size(); i++) {
+        CHECK_EQ(compact.getEmployeeId(i), employees[i]->getEmployeeId());
+        CHECK_EQ(compact.getEmail(i), employees[i]->getEmail());
+        CHECK_EQ(compact.getPhone(i), employees[i]->getPhone());
+        CHECK_EQ(compact.getDepartment(i), employees[i]->getDepartment());
+    }
+    CHECK_EQ(compact.findByName("Ann", "Lee").size(), size_t(2));
+    CHECK_EQ(compact.filterByDepartment("HR").size(), size_t(1));
+    CHECK(compact.filterByDepartment("Sales").empty());
+}
+
+static void testInternOverflow() {
+    // One more distinct department than a uint16 table can hold
+    const size_t count = InternTable::NOT_FOUND + size_t(2);
+    vector<shared_ptr<Employee>> employees;
+    employees.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        employees.push_back(makeEmployee("Dept " + to_string(i), "(123) 456-7890"));
+    }
+
+    CompactRoster compact;
+    compact.build(employees);
+    CHECK_EQ(compact.getDepartment(0), string("Dept 0"));
+    CHECK_EQ(compact.getDepartment(count - 1), "Dept " + to_string(count - 1));
+    CHECK_EQ(compact.getDepartment(count - 2), "Dept " + to_string(count - 2));
+
+    vector<size_t> last = compact.filterByDepartment("Dept " + to_string(count - 1));
+    CHECK_EQ(last.size(), size_t(1));
+    CHECK(!last.empty() && last.front() == count - 1);
+    CHECK_EQ(compact.filterByDepartment("Dept 7").size(), size_t(1));
+    CHECK(compact.filterByDepartment("Dept X").empty());
+    CHECK_EQ(compact.filterByType("intern").size(), count);
+}
+
+int main() {
+    testRoundTrip();
+    testInternOverflow();
+    return checkResult();
+}
@@ -0,0 +1,118 @@
+// Type tag dispatch, fixed-type records and the by-value variant
+#include "check.h"
+#include "employee.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// What a display call prints
+template<typename Fn>
+static string captured(Fn fn) {
+    ostringstream out;
+    streambuf* old = cout.rdbuf(out.rdbuf());
+    fn();
+    cout.rdbuf(old);
+    return out.str();
+}
+
+static bool contains(const string& text, const string& part) {
+    return text.find(part) != string::npos;
+}
+
+static void testTypeChange() {
+    Employee emp("Ann", "Lee", "ann@employee.com", "555-0100", "Female", "IT", "full-time");
+    string id = emp.getEmployeeId();
+    CHECK_EQ(emp.getKind(), KIND_FULL_TIME);
+    CHECK_EQ(emp.getSortingKey(), "FT_" + id);
+    CHECK(contains(captured([&] { emp.displayDetails(); }), "===== FULL-TIME EMPLOYEE ====="));
+
+    emp.markClean();
+    CHECK(emp.setEmployeeType("intern"));
+    CHECK_EQ(emp.getEmployeeType(), string("intern"));
+    CHECK_EQ(emp.getKind(), KIND_INTERN);
+    CHECK_EQ(emp.getSortingKey(), "IN_" + id);
+    string shown = captured([&] { emp.displayDetails(); });
+    CHECK(contains(shown, "===== INTERN EMPLOYEE ====="));
+    CHECK(contains(shown, "Employee Type:  intern"));
+    CHECK_EQ(emp.getDirtyFields(), unsigned(FIELD_EMPLOYEE_TYPE));
+
+    CHECK(emp.setEmployeeType("part-time"));
+    CHECK_EQ(emp.getKind(), KIND_PART_TIME);
+    CHECK_EQ(emp.getSortingKey(), "PT_" + id);
+    CHECK(contains(captured([&] { emp.displayDetails(); }), "===== PART-TIME EMPLOYEE ====="));
+
+    // Types without traits fall back to the plain banner and the bare ID
+    CHECK(emp.setEmployeeType("contractor"));
+    CHECK_EQ(emp.getKind(), KIND_OTHER);
+    CHECK_EQ(emp.getSortingKey(), id);
+    CHECK(contains(captured([&] { emp.displayDetails(); }), "===== EMPLOYEE ====="));
+}
+
+static void testFixedType() {
+    FullTimeEmployee emp("Bob", "Kim", "bob@employee.com", "555-0101", "Male", "HR");
+    CHECK_EQ(FullTimeEmployee::staticKind, KIND_FULL_TIME);
+    CHECK_EQ(emp.getKind(), KIND_FULL_TIME);
+
+    unsigned long revision = emp.getRevision();
+    CHECK(!emp.setEmployeeType("intern"));
+    CHECK(emp.setEmployeeType("full-time"));
+    CHECK_EQ(emp.getEmployeeType(), string("full-time"));
+    CHECK_EQ(emp.getRevision(), revision);
+
+    // The static and the tag-based versions agree
+    const Employee& base = emp;
+    CHECK_EQ(emp.getSortingKey(), base.getSortingKey());
+    CHECK_EQ(captured([&] { emp.displayDetails(); }), captured([&] { base.displayDetails(); }));
+
+    // Copies keep the fixed type, even as a plain Employee
+    Employee copy = emp;
+    CHECK(!copy.setEmployeeType("intern"));
+    CHECK_EQ(copy.getKind(), KIND_FULL_TIME);
+}
+
+static void testTypedRecords() {
+    vector<Employee> loaded;
+    loaded.emplace_back("Cy", "Ng", "cy@employee.com", "555-0102", "Other", "IT", "part-time");
+    loaded.emplace_back("Di", "Ox", "di@employee.com", "555-0103", "Female", "IT", "intern");
+    loaded.emplace_back("Ed", "Po", "ed@employee.com", "555-0104", "Male", "IT", "full-time");
+    loaded.emplace_back("Fa", "Qu", "fa@employee.com", "555-0105", "Male", "IT", "contractor");
+    loaded[1].setProfilePicture("0123456789abcdef");
+
+    vector<TypedEmployee> typed;
+    CHECK(appendTyped(loaded[0], typed));
+    CHECK(appendTyped(loaded[1], typed));
+    CHECK(appendTyped(loaded[2], typed));
+    CHECK(!appendTyped(loaded[3], typed));
+    CHECK_EQ(typed.size(), size_t(3));
+    CHECK(holds_alternative<PartTimeEmployee>(typed[0]));
+    CHECK(holds_alternative<InternEmployee>(typed[1]));
+    CHECK(holds_alternative<FullTimeEmployee>(typed[2]));
+
+    // Same record, not a new one
+    const Employee& intern = asEmployee(typed[1]);
+    CHECK_EQ(intern.getEmployeeId(), loaded[1].getEmployeeId());
+    CHECK_EQ(intern.getProfilePicture(), string("0123456789abcdef"));
+    CHECK_EQ(intern.getRevision(), loaded[1].getRevision());
+    CHECK_EQ(getSortingKey(typed[1]), loaded[1].getSortingKey());
+    CHECK_EQ(captured([&] { displayDetails(typed[1]); }), captured([&] { loaded[1].displayDetails(); }));
+
+    // The copy's type is fixed
+    CHECK(!get<InternEmployee>(typed[1]).setEmployeeType("full-time"));
+
+    sort(typed.begin(), typed.end(), [](const TypedEmployee& a, const TypedEmployee& b) {
+        return getSortingKey(a) < getSortingKey(b);
+    });
+    CHECK(holds_alternative<FullTimeEmployee>(typed[0]));
+    CHECK(holds_alternative<InternEmployee>(typed[1]));
+    CHECK(holds_alternative<PartTimeEmployee>(typed[2]));
+}
+
+int main() {
+    testTypeChange();
+    testFixedType();
+    testTypedRecords();
+    return checkResult();
+}
@@ -0,0 +1,157 @@
+// runQuery sort/page paths and the cache's invalidation rules
+#include "check.h"
+#include "query_cache.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+using namespace std;
+
+struct Roster {
+    vector<shared_ptr<Employee>> employees;
+    EmployeeIndex index;
+
+    void add(const string& fname, const string& lname, const string& dept, const string& type) {
+        auto emp = make_shared<Employee>(fname, lname, fname + "@employee.com", "(123) 456-7890",
+                                         "Other", dept, type);
+        employees.push_back(emp);
+        index[emp->getEmployeeId()] = emp;
+    }
+};
+
+static string names(const vector<shared_ptr<Employee>>& results) {
+    string joined;
+    for (const auto& emp : results) {
+        joined += (joined.empty() ? "" : ",") + emp->getFirstName();
+    }
+    return joined;
+}
+
+static Roster makeRoster() {
+    Employee::resetCounter();
+    Roster roster;
+    roster.add("Eve", "Stone", "IT", "full-time");
+    roster.add("Bob", "Young", "HR", "intern");
+    roster.add("Dan", "Avery", "IT", "part-time");
+    roster.add("Amy", "Cole", "IT", "intern");
+    roster.add("Cal", "Moss", "Sales", "full-time");
+    return roster;
+}
+
+static void testSortAndPage() {
+    Roster roster = makeRoster();
+    QueryCache cache;
+
+    Query byName(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME);
+    CHECK_EQ(names(runQuery(byName, roster.employees, roster.index, cache)), string("Amy,Dan,Eve"));
+    CHECK_EQ(names(runQuery(byName, roster.employees, roster.index, cache)), string("Amy,Dan,Eve"));
+    CHECK_EQ(cache.stats().hits, size_t(1));
+
+    Query byType(QUERY_NAME, MATCH_CONTAINS, "", SORT_TYPE);
+    CHECK_EQ(names(runQuery(byType, roster.employees, roster.index, cache)),
+             string("Cal,Eve,Amy,Bob,Dan"));
+
+    Query byId(QUERY_NAME, MATCH_CONTAINS, "", SORT_ID);
+    CHECK_EQ(names(runQuery(byId, roster.employees, roster.index, cache)),
+             string("Eve,Bob,Dan,Amy,Cal"));
+
+    // Pages are cached separately from the full result
+    Query page(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME, 1, 1);
+    CHECK(page.key() != byName.key());
+    CHECK_EQ(names(runQuery(page, roster.employees, roster.index, cache)), string("Dan"));
+    Query tail(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME, 2, 10);
+    CHECK_EQ(names(runQuery(tail, roster.employees, roster.index, cache)), string("Eve"));
+    Query past(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME, 5, 1);
+    CHECK(runQuery(past, roster.employees, roster.index, cache).empty());
+}
+
+static void testReorder() {
+    Roster roster = makeRoster();
+    QueryCache cache;
+
+    Query unsorted(QUERY_DEPARTMENT, MATCH_EXACT, "IT");
+    Query sorted(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME);
+    CHECK_EQ(names(runQuery(unsorted, roster.employees, roster.index, cache)), string("Eve,Dan,Amy"));
+    runQuery(sorted, roster.employees, roster.index, cache);
+
+    // Sorting the roster only changes results that follow roster order
+    sort(roster.employees.begin(), roster.employees.end(), compareByName);
+    cache.onReorder();
+
+    vector<string> ids;
+    CHECK(!cache.lookup(unsorted, ids));
+    CHECK(cache.lookup(sorted, ids));
+    CHECK_EQ(names(runQuery(unsorted, roster.employees, roster.index, cache)), string("Amy,Dan,Eve"));
+}
+
+static void testUpdates() {
+    Roster roster = makeRoster();
+    QueryCache cache;
+    vector<string> ids;
+
+    Query it(QUERY_DEPARTMENT, MATCH_EXACT, "IT");
+    Query itByName(QUERY_DEPARTMENT, MATCH_EXACT, "IT", SORT_NAME);
+    Query sales(QUERY_DEPARTMENT, MATCH_EXACT, "Sales");
+    runQuery(it, roster.employees, roster.index, cache);
+    runQuery(itByName, roster.employees, roster.index, cache);
+    runQuery(sales, roster.employees, roster.index, cache);
+
+    // A field no query reads invalidates nothing
+    Employee& eve = *roster.employees[0];
+    string old = eve.getEmail();
+    eve.setEmail("eve@example.com");
+    cache.onUpdate(eve, FIELD_EMAIL, old);
+    CHECK_EQ(cache.stats().entries, size_t(3));
+
+    // A name change only reaches the query sorted by name
+    old = eve.getFirstName();
+    eve.setFirstName("Ada");
+    cache.onUpdate(eve, FIELD_FIRST_NAME, old);
+    CHECK(cache.lookup(it, ids));
+    CHECK(!cache.lookup(itByName, ids));
+    CHECK(cache.lookup(sales, ids));
+
+    // Moving departments invalidates the old and new result, not others
+    Query hr(QUERY_DEPARTMENT, MATCH_EXACT, "HR");
+    runQuery(hr, roster.employees, roster.index, cache);
+    old = eve.getDepartment();
+    eve.setDepartment("Sales");
+    cache.onUpdate(eve, FIELD_DEPARTMENT, old);
+    CHECK(!cache.lookup(it, ids));
+    CHECK(!cache.lookup(sales, ids));
+    CHECK(cache.lookup(hr, ids));
+    CHECK_EQ(names(runQuery(sales, roster.employees, roster.index, cache)), string("Ada,Cal"));
+
+    // Adds and deletes only touch results the record belongs to
+    roster.add("Fay", "Hale", "HR", "intern");
+    cache.onAdd(*roster.employees.back());
+    CHECK(!cache.lookup(hr, ids));
+    CHECK(cache.lookup(sales, ids));
+}
+
+static void testEviction() {
+    Roster roster = makeRoster();
+    Query first(QUERY_DEPARTMENT, MATCH_EXACT, "IT");
+    Query second(QUERY_DEPARTMENT, MATCH_EXACT, "HR");
+
+    // Room for roughly one entry
+    QueryCache probe;
+    runQuery(first, roster.employees, roster.index, probe);
+    QueryCache cache(probe.stats().bytes + 64);
+
+    runQuery(first, roster.employees, roster.index, cache);
+    runQuery(second, roster.employees, roster.index, cache);
+    vector<string> ids;
+    CHECK_EQ(cache.stats().evictions, size_t(1));
+    CHECK(!cache.lookup(first, ids));
+    CHECK(cache.lookup(second, ids));
+}
+
+int main() {
+    testSortAndPage();
+    testReorder();
+    testUpdates();
+    testEviction();
+    return checkResult();
+}
@@ -0,0 +1,269 @@
+// Round trip through the file stand-in: load an export, sync, confirm
+// from a snapshot, and check the guards the next script carries.
+#include "check.h"
+#include "sync.h"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <ctime>
+#include <filesystem>
+
+using namespace std;
+
+static const char* ROSTER =
+    "EMP001\tAdmin\tUser\tadmin@employee.com\t(123) 456-7890\tMale\tIT\tfull-time\thttps://example.com/admin.png\t"
+    "2026-01-05 09:00:00.123456\t2026-01-05 09:00:00.654321\n"
+    "EMP002\tJohn\tO\\\\Doe\tjohn@employee.com\t\\N\tMale\tIT\tpart-time\tdata:image/png;base64,iVBORw0KGgo=\t"
+    "2026-01-05 09:00:01\t2026-01-06 10:30:00.5\n";
+
+// Eight bytes of PNG signature, as written inline in ROSTER
+static const std::string PNG_SIGNATURE("\x89PNG\r\n\x1a\n", 8);
+
+// Pictures imported by the tests, emptied at start
+static BlobStore* pictures = nullptr;
+
+static bool contains(const string& text, const string& part) {
+    return text.find(part) != string::npos;
+}
+
+static string snapshot(const vector<pair<string, SyncTime>>& rows) {
+    string text;
+    for (const auto& row : rows) {
+        text += row.first + "\t" + SyncEngine::formatTimestamp(row.second) + "\n";
+    }
+    return text;
+}
+
+static void testTimestamps() {
+    SyncTime t = 0;
+    CHECK(SyncEngine::parseTimestamp("2026-01-05 09:00:00.654321", t));
+    CHECK_EQ(SyncEngine::formatTimestamp(t), string("2026-01-05 09:00:00.654321"));
+    CHECK(SyncEngine::parseTimestamp("2026-03-01 00:00:00", t));
+    CHECK_EQ(SyncEngine::formatTimestamp(t), string("2026-03-01 00:00:00.000000"));
+    CHECK(SyncEngine::parseTimestamp("1969-12-31 23:59:59.9", t));
+    CHECK_EQ(SyncEngine::formatTimestamp(t), string("1969-12-31 23:59:59.900000"));
+    CHECK(!SyncEngine::parseTimestamp("2026-13-01 00:00:00", t));
+    CHECK(!SyncEngine::parseTimestamp("2026-01-01 00:00:00x", t));
+
+    time_t now = time(nullptr);
+    CHECK_EQ(SyncEngine::toTimeT(SyncEngine::toSyncTime(now)), now);
+
+    CHECK_EQ(SyncEngine::unescapeCopy(SyncEngine::escapeCopy("a\tb\\c\nd")), string("a\tb\\c\nd"));
+}
+
+static void testRoundTrip() {
+    SyncEngine engine(*pictures);
+    vector<shared_ptr<Employee>> employees;
+    istringstream roster(ROSTER);
+
+    CHECK(engine.loadRoster(roster, employees));
+    CHECK_EQ(employees.size(), size_t(2));
+    CHECK_EQ(employees[1]->getLastName(), string("O\\Doe"));
+    CHECK_EQ(employees[1]->getPhone(), string(""));
+    // Inline pictures are imported and only the handle kept; URLs stay in the database
+    CHECK_EQ(employees[1]->getProfilePicture(), BlobStore::hashOf(PNG_SIGNATURE));
+    CHECK_EQ(pictures->dataUriFor(employees[1]->getProfilePicture()),
+             string("data:image/png;base64,iVBORw0KGgo="));
+    CHECK_EQ(employees[0]->getProfilePicture(), string(""));
+    CHECK(!employees[0]->isDirty());
+    CHECK(employees[0]->isPersisted());
+
+    // Nothing changed, nothing written
+    ostringstream empty;
+    engine.sync(employees, empty);
+    CHECK(empty.str().empty());
+    CHECK(!engine.hasUnconfirmed());
+
+    // The loaded rows continue the ID sequence
+    employees.push_back(make_shared<Employee>("New", "Hire", "new@employee.com", "(555) 000-0000",
+                                              "Female", "HR", "intern"));
+    CHECK_EQ(employees[2]->getEmployeeId(), string("EMP003"));
+    employees[0]->setEmail("admin@example.com");
+
+    ostringstream first;
+    SyncReport report = engine.sync(employees, first);
+    CHECK_EQ(report.inserted, size_t(1));
+    CHECK_EQ(report.updated, size_t(1));
+    CHECK(report.conflicts.empty());
+    // The guard keeps the fractional seconds of the exported updated_at
+    CHECK(contains(first.str(), "'2026-01-05 09:00:00.654321'::timestamp)"));
+    CHECK(contains(first.str(), "updated_at = '" + SyncEngine::formatTimestamp(report.stamp) + "'"));
+    CHECK(!contains(first.str(), "NULL::timestamp"));
+    // The new hire has no picture: NULL, not an empty string
+    CHECK(contains(first.str(), "'intern', NULL, "));
+
+    // Written but not confirmed: still dirty
+    CHECK(engine.hasUnconfirmed());
+    CHECK(employees[0]->isDirty());
+    CHECK(employees[2]->isDirty());
+
+    // The snapshot shows the insert landed but not the update
+    SyncTime emp002 = 0;
+    SyncEngine::parseTimestamp("2026-01-06 10:30:00.5", emp002);
+    SyncTime before = 0;
+    SyncEngine::parseTimestamp("2026-01-05 09:00:00.654321", before);
+    istringstream partial(snapshot({ { "EMP001", before }, { "EMP002", emp002 },
+                                     { "EMP003", report.stamp } }));
+    CHECK(engine.loadRemoteState(partial));
+    CHECK_EQ(engine.confirmedCount(), size_t(1));
+    CHECK(employees[0]->isDirty());
+    CHECK(!employees[2]->isDirty());
+    CHECK(employees[2]->isPersisted());
+
+    // The update is written again against the same base
+    ostringstream retry;
+    SyncReport second = engine.sync(employees, retry);
+    CHECK_EQ(second.inserted, size_t(0));
+    CHECK_EQ(second.updated, size_t(1));
+    CHECK(second.stamp > report.stamp);
+    CHECK(contains(retry.str(), "'2026-01-05 09:00:00.654321'::timestamp)"));
+
+    // A change made while the script runs is not lost on acknowledge
+    employees[0]->setPhone("(999) 999-9999");
+    engine.acknowledge();
+    CHECK(employees[0]->isDirty());
+
+    ostringstream third;
+    SyncReport next = engine.sync(employees, third);
+    CHECK_EQ(next.updated, size_t(1));
+    // Guarded by the stamp the acknowledged script wrote
+    CHECK(contains(third.str(), "'" + SyncEngine::formatTimestamp(second.stamp) + "'::timestamp)"));
+    engine.acknowledge();
+    CHECK(!employees[0]->isDirty());
+
+    // A new picture handle is synced like any other column
+    employees[1]->setProfilePicture(pictures->put("GIF89a"));
+    CHECK_EQ(employees[1]->getDirtyFields(), unsigned(FIELD_PROFILE_PICTURE));
+    ostringstream picture;
+    engine.sync(employees, picture);
+    CHECK(contains(picture.str(), "SET profile_picture = v.profile_picture, updated_at"));
+    // ...and goes out inline, the way other readers of the column expect
+    CHECK(contains(picture.str(), "('EMP002', 'data:image/gif;base64,R0lGODlh', "));
+}
+
+static void testConflicts() {
+    SyncEngine engine(*pictures);
+    vector<shared_ptr<Employee>> employees;
+    istringstream roster(ROSTER);
+    CHECK(engine.loadRoster(roster, employees));
+
+    // EMP002 changed remotely; EMP009 was added by someone else
+    SyncTime base = 0, later = 0;
+    SyncEngine::parseTimestamp("2026-01-05 09:00:00.654321", base);
+    SyncEngine::parseTimestamp("2026-01-07 08:00:00", later);
+    istringstream remote(snapshot({ { "EMP001", base }, { "EMP002", later }, { "EMP009", later } }));
+    CHECK(engine.loadRemoteState(remote));
+
+    employees[1]->setDepartment("HR");
+    auto stranger = make_shared<Employee>("Other", "Person", "other@employee.com", "(555) 111-1111",
+                                          "Male", "IT", "full-time");
+    stranger->setEmployeeId("EMP009");
+    employees.push_back(stranger);
+
+    ostringstream out;
+    SyncReport report = engine.sync(employees, out);
+    CHECK_EQ(report.conflicts.size(), size_t(2));
+    CHECK(employees[1]->isDirty());
+    CHECK(out.str().empty());
+
+    // A conflicting delete stays pending instead of being dropped
+    engine.recordDelete(*employees[1]);
+    employees.erase(employees.begin() + 1);
+    ostringstream again;
+    report = engine.sync(employees, again);
+    CHECK_EQ(engine.pendingDeleteCount(), size_t(1));
+
+    // Without a conflict the delete carries its base, and is
+    // confirmed once a snapshot shows the row gone
+    SyncEngine fresh(*pictures);
+    vector<shared_ptr<Employee>> reloaded;
+    istringstream roster2(ROSTER);
+    CHECK(fresh.loadRoster(roster2, reloaded));
+    fresh.recordDelete(*reloaded[0]);
+    ostringstream del;
+    report = fresh.sync(reloaded, del);
+    CHECK_EQ(report.deleted, size_t(1));
+    CHECK(contains(del.str(), "('EMP001', '2026-01-05 09:00:00.654321'::timestamp)"));
+    istringstream refreshed(snapshot({ { "EMP002", later } }));
+    CHECK(fresh.loadRemoteState(refreshed));
+    CHECK_EQ(fresh.confirmedCount(), size_t(1));
+    CHECK_EQ(fresh.pendingDeleteCount(), size_t(0));
+}
+
+static void testGuards() {
+    SyncEngine engine(*pictures);
+    vector<shared_ptr<Employee>> employees;
+    istringstream roster(ROSTER);
+    CHECK(engine.loadRoster(roster, employees));
+
+    // A remote edit stamped by a server clock behind ours is still a conflict
+    SyncTime base = 0, earlier = 0, emp002 = 0;
+    SyncEngine::parseTimestamp("2026-01-05 09:00:00.654321", base);
+    SyncEngine::parseTimestamp("2026-01-05 07:00:00", earlier);
+    SyncEngine::parseTimestamp("2026-01-06 10:30:00.5", emp002);
+    istringstream remote(snapshot({ { "EMP001", earlier }, { "EMP002", emp002 } }));
+    CHECK(engine.loadRemoteState(remote));
+
+    employees[0]->setEmail("admin@example.com");
+    ostringstream skipped;
+    SyncReport report = engine.sync(employees, skipped);
+    CHECK_EQ(report.conflicts.size(), size_t(1));
+    CHECK(skipped.str().empty());
+    engine.acknowledge();
+    CHECK(employees[0]->isDirty());
+
+    // Without a snapshot the database has the final say: every guarded
+    // statement checks its row count and aborts the transaction on a miss
+    SyncEngine blind(*pictures);
+    vector<shared_ptr<Employee>> fresh;
+    istringstream roster2(ROSTER);
+    CHECK(blind.loadRoster(roster2, fresh));
+    fresh[0]->setEmail("admin@example.com");
+    fresh[1]->setPhone("(555) 222-3333");
+    ostringstream out;
+    report = blind.sync(fresh, out);
+    CHECK_EQ(report.updated, size_t(2));
+    CHECK(contains(out.str(), "WITH changed AS (\nUPDATE employees"));
+    CHECK(contains(out.str(), "SELECT sync_expect_rows(1, count(*), 'UPDATE') FROM changed;"));
+
+    blind.recordDelete(*fresh[1]);
+    fresh.pop_back();
+    blind.acknowledge();
+    ostringstream del;
+    blind.sync(fresh, del);
+    CHECK(contains(del.str(), "SELECT sync_expect_rows(1, count(*), 'DELETE') FROM removed;"));
+
+    // A row whose insert was never confirmed may not exist: its delete
+    // must not abort the script
+    SyncEngine pending(*pictures);
+    vector<shared_ptr<Employee>> rows;
+    istringstream roster3(ROSTER);
+    CHECK(pending.loadRoster(roster3, rows));
+    rows.push_back(make_shared<Employee>("New", "Hire", "new@employee.com", "(555) 000-0000",
+                                         "Female", "HR", "intern"));
+    ostringstream insert;
+    SyncReport inserted = pending.sync(rows, insert);
+    pending.recordDelete(*rows.back());
+    rows.pop_back();
+    ostringstream maybe;
+    report = pending.sync(rows, maybe);
+    CHECK_EQ(report.deleted, size_t(1));
+    CHECK(contains(maybe.str(), "'" + SyncEngine::formatTimestamp(inserted.stamp) + "'::timestamp)"));
+    CHECK(!contains(maybe.str(), "sync_expect_rows"));
+    pending.acknowledge();
+    CHECK_EQ(pending.pendingDeleteCount(), size_t(0));
+}
+
+int main() {
+    const char* root = "build/test_sync_blobs";
+    std::filesystem::remove_all(root);
+    BlobStore store(root);
+    pictures = &store;
+
+    testTimestamps();
+    testRoundTrip();
+    testConflicts();
+    testGuards();
+    return checkResult();
+}
@@ -0,0 +1,73 @@
+// Exception safety and nesting across pools
+#include "check.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void testExceptions() {
+    ThreadPool pool(4);
+
+    // Thrown from a queued chunk and from the caller's own first chunk
+    for (size_t failAt : { size_t(900), size_t(0) }) {
+        atomic<size_t> visited(0);
+        string message;
+        try {
+            pool.parallelFor(0, 1000, 10, [&](size_t lo, size_t hi) {
+                visited += hi - lo;
+                if (lo <= failAt && failAt < hi) {
+                    throw runtime_error("chunk failed");
+                }
+            });
+        } catch (const runtime_error& e) {
+            message = e.what();
+        }
+        CHECK_EQ(message, string("chunk failed"));
+        // Every chunk still ran before the call returned
+        CHECK_EQ(visited.load(), size_t(1000));
+    }
+
+    // The pool keeps working afterwards
+    long sum = pool.parallelReduce(0, 1000, 10, 0L,
+        [](size_t lo, size_t hi) { return static_cast<long>(hi - lo); },
+        [](long a, long b) { return a + b; });
+    CHECK_EQ(sum, 1000L);
+}
+
+static void testNestedPools() {
+    // Workers of the larger pool must not use their index in the smaller one
+    ThreadPool outer(4);
+    ThreadPool inner(1);
+    atomic<size_t> total(0);
+
+    outer.parallelFor(0, 64, 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; i++) {
+            inner.parallelFor(0, 100, 10, [&](size_t a, size_t b) { total += b - a; });
+        }
+    });
+    CHECK_EQ(total.load(), size_t(6400));
+}
+
+static void testSort() {
+    ThreadPool pool(3);
+    vector<int> values(50000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<int>((i * 7919) % values.size());
+    }
+    pool.parallelSort(values.begin(), values.end(), [](int a, int b) { return a < b; });
+    bool sorted = true;
+    for (size_t i = 0; i < values.size(); i++) {
+        sorted = sorted && values[i] == static_cast<int>(i);
+    }
+    CHECK(sorted);
+}
+
+int main() {
+    testExceptions();
+    testNestedPools();
+    testSort();
+    return checkResult();
+}